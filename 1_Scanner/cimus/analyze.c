@@ -9,6 +9,7 @@
 #include "globals.h"
 #include "symtab.h"
 #include "analyze.h"
+#include "lineidx.h"
 
 /* counter for variable memory locations */
 static int location = 0;
@@ -53,11 +54,11 @@ static void insertNode( TreeNode * t)
         case ReadK:
           if (st_lookup(t->attr.name) == -1)
           /* not yet in table, so treat as new definition */
-            st_insert(t->attr.name,t->lineno,location++);
+            st_insert(t->attr.name,lineOf(t->offset),location++);
           else
           /* already in table, so ignore location, 
              add line number of use only */ 
-            st_insert(t->attr.name,t->lineno,0);
+            st_insert(t->attr.name,lineOf(t->offset),0);
           break;
         default:
           break;
@@ -68,11 +69,11 @@ static void insertNode( TreeNode * t)
       { case IdK:
           if (st_lookup(t->attr.name) == -1)
           /* not yet in table, so treat as new definition */
-            st_insert(t->attr.name,t->lineno,location++);
+            st_insert(t->attr.name,lineOf(t->offset),location++);
           else
           /* already in table, so ignore location, 
              add line number of use only */ 
-            st_insert(t->attr.name,t->lineno,0);
+            st_insert(t->attr.name,lineOf(t->offset),0);
           break;
         default:
           break;
@@ -95,7 +96,7 @@ void buildSymtab(TreeNode * syntaxTree)
 }
 
 static void typeError(TreeNode * t, char * message)
-{ fprintf(listing,"Type error at line %d: %s\n",t->lineno,message);
+{ fprintf(listing,"Type error at line %d: %s\n",lineOf(t->offset),message);
   Error = TRUE;
 }
 
@@ -0,0 +1,40 @@
+/****************************************************/
+/* File: flexscan.h                                 */
+/* Reentrant interface to the flex scanner          */
+/* (cminus.l)                                       */
+/****************************************************/
+
+#ifndef _FLEXSCAN_H_
+#define _FLEXSCAN_H_
+
+/* ScanState holds everything one flex scanner works
+ * on, so several scanners may run at once in one
+ * process, each over its own text. The caller owns
+ * the record and the text; token offsets in tok are
+ * relative to text rather than to srcText
+ */
+typedef struct
+   { void * yy;     /* flex's own state (a yyscan_t) */
+     char * text;   /* text being scanned */
+     long len;      /* length of text in bytes */
+     TokenRec tok;  /* token most recently returned */
+   } ScanState;
+
+/* Function scanOpen prepares s to scan the len bytes
+ * at text, which must be followed by two '\0' bytes
+ * (as srcText is, see source.h). Returns FALSE if the
+ * scanner could not be created
+ */
+int scanOpen( ScanState * s, char * text, long len );
+
+/* Function scanNext returns the next token of s and
+ * describes it in s->tok
+ */
+TokenType scanNext( ScanState * s );
+
+/* Procedure scanClose releases the flex state of s,
+ * leaving its text to the caller
+ */
+void scanClose( ScanState * s );
+
+#endif
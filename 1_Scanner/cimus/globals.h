@@ -23,7 +23,7 @@
 #endif
 
 /* MAXRESERVED = the number of reserved words */
-#define MAXRESERVED 12
+#define MAXRESERVED 6
 
 typedef enum 
     /* book-keeping tokens */
@@ -40,8 +40,6 @@ extern FILE* source; /* source code text file */
 extern FILE* listing; /* listing output text file */
 extern FILE* code; /* code text file for TM simulator */
 
-extern int lineno; /* source line number for listing */
-
 /**************************************************/
 /***********   Syntax tree for parsing ************/
 /**************************************************/
@@ -58,7 +56,7 @@ typedef enum {Void,Integer,Boolean} ExpType;
 typedef struct treeNode
    { struct treeNode * child[MAXCHILDREN];
      struct treeNode * sibling;
-     int lineno;
+     int offset; /* position in srcText, -1 if none; see lineidx.h */
      NodeKind nodekind;
      union { StmtKind stmt; ExpKind exp;} kind;
      union { TokenType op;
@@ -83,6 +81,28 @@ extern int EchoSource;
  */
 extern int TraceScan;
 
+/* MapSource = TRUE causes the scanner to map the
+ * source file into memory when it is a regular file;
+ * otherwise the file is read into a buffer. Either
+ * way the whole source is scanned in place
+ */
+extern int MapSource;
+
+/* TableScan = TRUE selects the table-driven scanner
+ * DFA instead of the hand-coded switch one; both
+ * produce the same token stream
+ */
+extern int TableScan;
+
+/* ScanThreads = number of threads lexing the source
+ * in parallel chunks (see parscan.h); 1 scans it
+ * sequentially and 0 uses one thread per processor.
+ * scanThreads caps it by the processors and the
+ * source size, scanning sequentially if that
+ * leaves one thread
+ */
+extern int ScanThreads;
+
 /* TraceParse = TRUE causes the syntax tree to be
  * printed to the listing file in linearized form
  * (using indents for children)
@@ -0,0 +1,37 @@
+/****************************************************/
+/* File: lineidx.h                                  */
+/* Newline index over the source buffer: maps byte  */
+/* offsets in srcText to line and column numbers    */
+/****************************************************/
+
+#ifndef _LINEIDX_H_
+#define _LINEIDX_H_
+
+/* Tokens and syntax tree nodes record where they
+ * are by byte offset in srcText (see source.h);
+ * their line numbers are worked out only when a
+ * listing or diagnostic needs them, from an index
+ * of the offset at which each line starts
+ */
+
+/* Function buildLineIndex indexes the line starts
+ * of srcText in one memchr pass over it. It must be
+ * called after srcText is loaded and before a
+ * scanner writes into it. Returns FALSE if it runs
+ * out of memory
+ */
+int buildLineIndex( void );
+
+/* Function lineOf returns the line holding the
+ * byte at offset in srcText, counting from 1;
+ * offset srcLen is the line of end of file, and a
+ * negative offset (a node with no position) gives 0
+ */
+int lineOf( long offset );
+
+/* Function columnOf returns the column of the byte
+ * at offset within its line, counting from 1
+ */
+int columnOf( long offset );
+
+#endif
@@ -31,7 +31,6 @@
 #endif
 
 /* allocate global variables */
-int lineno = 0;
 FILE * source;
 FILE * listing;
 FILE * code;
@@ -39,6 +38,9 @@ FILE * code;
 /* allocate and set tracing flags */
 int EchoSource = TRUE;
 int TraceScan = TRUE;
+int MapSource = TRUE;
+int TableScan = FALSE;
+int ScanThreads = 1;
 int TraceParse = FALSE;
 int TraceAnalyze = FALSE;
 int TraceCode = FALSE;
@@ -0,0 +1,208 @@
+/****************************************************/
+/* File: parscan.c                                  */
+/* Parallel chunked lexing for the C-Minus          */
+/* scanners                                         */
+/****************************************************/
+
+#include <pthread.h>
+#include <unistd.h>
+#include "globals.h"
+#include "scan.h"
+#include "source.h"
+#include "token.h"
+#include "parscan.h"
+
+/* MINCHUNK = smallest chunk worth a thread of its
+   own; MAXCHUNKS = most chunks a source is cut into */
+#define MINCHUNK (1L << 20)
+#define MAXCHUNKS 256
+
+/* one chunk of srcText and the tokens lexed from it */
+typedef struct
+   { char * begin;     /* first character of the chunk */
+     char * end;       /* first character after it */
+     TokenStream ts;   /* its tokens */
+     int ok;           /* FALSE if lexing it failed */
+     TokenRec * out;   /* where its tokens go in the joined stream */
+   } Chunk;
+
+/* findOpen returns the first comment opening
+   ('/' then '*') starting in [p,end), or NULL */
+static char * findOpen( char * p, char * end )
+{ while ((p = memchr(p,'/',end-p)) != NULL)
+  { if (p[1] == '*') return p;
+    p++;
+  }
+  return NULL;
+}
+
+/* findClose returns the character after the first
+   comment closing ('*' then '/') starting at or
+   after p, or NULL */
+static char * findClose( char * p, char * end )
+{ char * q = p;
+  while ((q = memchr(q,'/',end-q)) != NULL)
+  { if ((q > p) && (q[-1] == '*')) return q+1;
+    q++;
+  }
+  return NULL;
+}
+
+/* splitChunks cuts srcText into at most n chunks,
+ * returning their number. Each cut goes at the first
+ * line start after an even split of the text; a cut
+ * that falls inside a comment moves to the end of
+ * the comment. The comment state at each cut comes
+ * from a pre-pass that only looks at the '/' of
+ * comment delimiters, far less work than lexing
+ */
+static int splitChunks( Chunk * c, int n )
+{ char * end = srcText + srcLen;
+  char * pos = srcText; /* pre-pass position, outside any comment */
+  int k = 0;
+  int i;
+  c[0].begin = srcText;
+  for (i=1;i<n;i++)
+  { char * b = srcText + srcLen / n * i;
+    if (b <= c[k].begin) b = c[k].begin + 1;
+    if (b >= end) break;
+    b = memchr(b,'\n',end-b);
+    if ((b == NULL) || (++b >= end)) break;
+    for (;;)
+    { char * open = findOpen(pos,b);
+      char * close;
+      if (open == NULL)
+      { pos = b;
+        break;
+      }
+      close = findClose(open+2,end);
+      if (close == NULL) /* unterminated: b is in the last chunk */
+      { b = end;
+        break;
+      }
+      pos = close;
+      if (close > b)
+      { b = close;
+        break;
+      }
+    }
+    if (b >= end) break;
+    c[k].end = b;
+    c[++k].begin = b;
+  }
+  c[k].end = end;
+  return k+1;
+}
+
+/* runChunks applies fn to each of the n chunks,
+   one thread per chunk with the caller taking the
+   first */
+static void runChunks( Chunk * c, int n, void * (* fn) (void *) )
+{ pthread_t tid[MAXCHUNKS];
+  int started[MAXCHUNKS];
+  int i;
+  for (i=1;i<n;i++)
+  { started[i] = (pthread_create(&tid[i],NULL,fn,&c[i]) == 0);
+    if (!started[i]) fn(&c[i]);
+  }
+  fn(&c[0]);
+  for (i=1;i<n;i++)
+    if (started[i]) pthread_join(tid[i],NULL);
+}
+
+/* lexChunk lexes one chunk */
+static void * lexChunk( void * arg )
+{ Chunk * c = (Chunk *) arg;
+  c->ok = scanChunk(c->begin,c->end,&c->ts);
+  return NULL;
+}
+
+/* joinChunk copies the tokens of one chunk into
+   the joined stream; token offsets are into srcText
+   already, so they need no correcting */
+static void * joinChunk( void * arg )
+{ Chunk * c = (Chunk *) arg;
+  if (c->ts.count > 0)
+    memcpy(c->out,c->ts.tok,c->ts.count*sizeof(TokenRec));
+  freeTokens(&c->ts);
+  return NULL;
+}
+
+/* Function scanThreads returns the number of
+ * threads parallelScan lexes srcText on
+ */
+int scanThreads( void )
+{ int threads = ScanThreads;
+  long cpus;
+  if (threads == 1) return 1;
+  cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  if ((threads <= 0) || (threads > cpus)) threads = (int) cpus;
+  if (threads > MAXCHUNKS) threads = MAXCHUNKS;
+  if (threads > srcLen / MINCHUNK) threads = (int) (srcLen / MINCHUNK);
+  if (threads < 1) threads = 1;
+  return threads;
+}
+
+/* Function parallelScan lexes all of srcText into
+ * ts, ending with the ENDFILE token
+ */
+int parallelScan( TokenStream * ts )
+{ static Chunk c[MAXCHUNKS];
+  int n, i, total;
+  TokenRec eof;
+  n = splitChunks(c,scanThreads());
+  for (i=0;i<n;i++)
+  { c[i].ts.tok = NULL;
+    c[i].ts.count = c[i].ts.capacity = 0;
+  }
+  runChunks(c,n,lexChunk);
+  total = 0;
+  for (i=0;i<n;i++)
+  { if (!c[i].ok) break;
+    total += c[i].ts.count;
+  }
+  if ((i == n) && (ts->capacity < total+1))
+  { TokenRec * p = (TokenRec *) realloc(ts->tok,(total+1)*sizeof(TokenRec));
+    if (p == NULL)
+      fprintf(listing,"Out of memory error joining tokens\n");
+    else
+    { ts->tok = p;
+      ts->capacity = total+1;
+    }
+  }
+  if ((i < n) || (ts->capacity < total+1))
+  { for (i=0;i<n;i++) freeTokens(&c[i].ts);
+    return FALSE;
+  }
+  total = 0;
+  for (i=0;i<n;i++)
+  { c[i].out = ts->tok + total;
+    total += c[i].ts.count;
+  }
+  runChunks(c,n,joinChunk);
+  eof.kind = ENDFILE;
+  eof.offset = (int) srcLen;
+  eof.length = 0;
+  ts->tok[total] = eof;
+  ts->count = total+1;
+  return TRUE;
+}
+
+/* Function parallelToken returns the next token of
+ * srcText lexed with parallelScan
+ */
+TokenType parallelToken( void )
+{ static TokenStream ts;
+  static int next = -1;
+  if (next < 0)
+  { next = 0;
+    if (!parallelScan(&ts))
+    { Error = TRUE;
+      return ENDFILE;
+    }
+  }
+  if (next >= ts.count) return ENDFILE;
+  tokenRec = ts.tok[next];
+  if (tokenRec.kind != ENDFILE) next++;
+  return tokenRec.kind;
+}
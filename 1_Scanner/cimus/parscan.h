@@ -0,0 +1,54 @@
+/****************************************************/
+/* File: parscan.h                                  */
+/* Parallel chunked lexing for the C-Minus          */
+/* scanners                                         */
+/****************************************************/
+
+#ifndef _PARSCAN_H_
+#define _PARSCAN_H_
+
+/* C-Minus tokens never span a newline except inside
+ * a comment, so srcText can be cut into chunks at
+ * line starts outside comments and the chunks lexed
+ * independently. Each scanner supplies scanChunk
+ * for its own DFA; the rest is shared
+ */
+
+/* Function scanChunk appends the tokens of the text
+ * from begin up to end to ts, without the ENDFILE
+ * token. begin and end lie in srcText, and end is
+ * outside any comment or the end of srcText itself.
+ * Token offsets are into srcText, so tokens need
+ * no correcting when the chunks are joined. Returns
+ * FALSE on failure. It keeps no state between calls
+ * and so may run on several threads at once
+ */
+int scanChunk( char * begin, char * end, TokenStream * ts );
+
+/* Function scanThreads returns the number of
+ * threads parallelScan lexes srcText on: ScanThreads,
+ * or one per processor if it is 0, but no more than
+ * there are processors or 1 MB chunks of srcText.
+ * srcText must be loaded. getToken lexes srcText
+ * sequentially when this is 1, since chunked lexing
+ * only pays off on several processors: it holds the
+ * whole token stream (some 4 times the peak memory
+ * of the sequential scan) and, on one processor, is
+ * about half as fast as the sequential scan
+ */
+int scanThreads( void );
+
+/* Function parallelScan lexes all of srcText into
+ * ts, ending with the ENDFILE token, on scanThreads()
+ * threads. Returns FALSE on failure
+ */
+int parallelScan( TokenStream * ts );
+
+/* Function parallelToken returns the next token of
+ * srcText lexed with parallelScan, lexing it on the
+ * first call, and sets tokenRec as getToken does.
+ * srcText must be loaded and its lines indexed
+ */
+TokenType parallelToken( void );
+
+#endif
@@ -8,6 +8,7 @@
 #include "globals.h"
 #include "util.h"
 #include "scan.h"
+#include "token.h"
 #include "parse.h"
 
 static TokenType token; /* holds current token */
@@ -27,15 +28,22 @@ static TreeNode * factor(void);
 
 static void syntaxError(char * message)
 { fprintf(listing,"\n>>> ");
-  fprintf(listing,"Syntax error at line %d: %s",lineno,message);
+  fprintf(listing,"Syntax error at line %d: %s",tokenLine(&tokenRec),message);
   Error = TRUE;
 }
 
+/* here gives node t the position of the
+   current token */
+static TreeNode * here(TreeNode * t)
+{ if (t!=NULL) t->offset = tokenRec.offset;
+  return t;
+}
+
 static void match(TokenType expected)
 { if (token == expected) token = getToken();
   else {
     syntaxError("unexpected token -> ");
-    printToken(token,tokenString);
+    printTokenRec(&tokenRec);
     fprintf(listing,"      ");
   }
 }
@@ -68,7 +76,7 @@ TreeNode * statement(void)
     case READ : t = read_stmt(); break;
     case WRITE : t = write_stmt(); break;
     default : syntaxError("unexpected token -> ");
-              printToken(token,tokenString);
+              printTokenRec(&tokenRec);
               token = getToken();
               break;
   } /* end case */
@@ -76,7 +84,7 @@ TreeNode * statement(void)
 }
 
 TreeNode * if_stmt(void)
-{ TreeNode * t = newStmtNode(IfK);
+{ TreeNode * t = here(newStmtNode(IfK));
   match(IF);
   if (t!=NULL) t->child[0] = exp();
   match(THEN);
@@ -90,7 +98,7 @@ TreeNode * if_stmt(void)
 }
 
 TreeNode * repeat_stmt(void)
-{ TreeNode * t = newStmtNode(RepeatK);
+{ TreeNode * t = here(newStmtNode(RepeatK));
   match(REPEAT);
   if (t!=NULL) t->child[0] = stmt_sequence();
   match(UNTIL);
@@ -99,9 +107,9 @@ TreeNode * repeat_stmt(void)
 }
 
 TreeNode * assign_stmt(void)
-{ TreeNode * t = newStmtNode(AssignK);
+{ TreeNode * t = here(newStmtNode(AssignK));
   if ((t!=NULL) && (token==ID))
-    t->attr.name = copyString(tokenString);
+    t->attr.name = tokenLexeme(&tokenRec);
   match(ID);
   match(ASSIGN);
   if (t!=NULL) t->child[0] = exp();
@@ -109,16 +117,16 @@ TreeNode * assign_stmt(void)
 }
 
 TreeNode * read_stmt(void)
-{ TreeNode * t = newStmtNode(ReadK);
+{ TreeNode * t = here(newStmtNode(ReadK));
   match(READ);
   if ((t!=NULL) && (token==ID))
-    t->attr.name = copyString(tokenString);
+    t->attr.name = tokenLexeme(&tokenRec);
   match(ID);
   return t;
 }
 
 TreeNode * write_stmt(void)
-{ TreeNode * t = newStmtNode(WriteK);
+{ TreeNode * t = here(newStmtNode(WriteK));
   match(WRITE);
   if (t!=NULL) t->child[0] = exp();
   return t;
@@ -127,7 +135,7 @@ TreeNode * write_stmt(void)
 TreeNode * exp(void)
 { TreeNode * t = simple_exp();
   if ((token==LT)||(token==EQ)) {
-    TreeNode * p = newExpNode(OpK);
+    TreeNode * p = here(newExpNode(OpK));
     if (p!=NULL) {
       p->child[0] = t;
       p->attr.op = token;
@@ -143,7 +151,7 @@ TreeNode * exp(void)
 TreeNode * simple_exp(void)
 { TreeNode * t = term();
   while ((token==PLUS)||(token==MINUS))
-  { TreeNode * p = newExpNode(OpK);
+  { TreeNode * p = here(newExpNode(OpK));
     if (p!=NULL) {
       p->child[0] = t;
       p->attr.op = token;
@@ -158,7 +166,7 @@ TreeNode * simple_exp(void)
 TreeNode * term(void)
 { TreeNode * t = factor();
   while ((token==TIMES)||(token==OVER))
-  { TreeNode * p = newExpNode(OpK);
+  { TreeNode * p = here(newExpNode(OpK));
     if (p!=NULL) {
       p->child[0] = t;
       p->attr.op = token;
@@ -174,15 +182,15 @@ TreeNode * factor(void)
 { TreeNode * t = NULL;
   switch (token) {
     case NUM :
-      t = newExpNode(ConstK);
+      t = here(newExpNode(ConstK));
       if ((t!=NULL) && (token==NUM))
-        t->attr.val = atoi(tokenString);
+        t->attr.val = tokenValue(&tokenRec);
       match(NUM);
       break;
     case ID :
-      t = newExpNode(IdK);
+      t = here(newExpNode(IdK));
       if ((t!=NULL) && (token==ID))
-        t->attr.name = copyString(tokenString);
+        t->attr.name = tokenLexeme(&tokenRec);
       match(ID);
       break;
     case LPAREN :
@@ -192,7 +200,7 @@ TreeNode * factor(void)
       break;
     default:
       syntaxError("unexpected token -> ");
-      printToken(token,tokenString);
+      printTokenRec(&tokenRec);
       token = getToken();
       break;
     }
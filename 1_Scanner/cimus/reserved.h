@@ -0,0 +1,53 @@
+/****************************************************/
+/* File: reserved.h                                 */
+/* Reserved word lookup shared by the hand-written  */
+/* scanner (scan.c) and the flex scanner (cminus.l) */
+/****************************************************/
+
+#ifndef _RESERVED_H_
+#define _RESERVED_H_
+
+/* RW_SLOTS = size of the reserved word hash table,
+   RW_MAXLEN = length of the longest reserved word */
+#define RW_SLOTS 8
+#define RW_MAXLEN 6
+
+/* RW_HASH is a perfect hash of the reserved words
+ * keyed only on length and first character: each
+ * of the MAXRESERVED words lands in its own slot
+ */
+#define RW_HASH(c,len) ((((c) >> 1) ^ ((len) << 2)) & (RW_SLOTS-1))
+
+/* reserved word table, laid out by the compiler
+ * from RW_HASH; empty slots have len 0 and so
+ * never match
+ */
+static const struct
+    { char str[RW_MAXLEN+1];
+      int len;
+      TokenType tok;
+    } reservedWords[RW_SLOTS]
+   = {[RW_HASH('i',2)] = {"if",2,IF},
+      [RW_HASH('e',4)] = {"else",4,ELSE},
+      [RW_HASH('w',5)] = {"while",5,WHILE},
+      [RW_HASH('r',6)] = {"return",6,RETURN},
+      [RW_HASH('i',3)] = {"int",3,INT},
+      [RW_HASH('v',4)] = {"void",4,VOID}
+     };
+
+/* lookup an identifier of length len to see if it
+ * is a reserved word; an identifier is rejected on
+ * its length or first character before any of the
+ * remaining characters are compared
+ */
+static TokenType reservedLookup (const char * s, int len)
+{ int c = (unsigned char) s[0];
+  if (len > RW_MAXLEN) return ID;
+  if ((reservedWords[RW_HASH(c,len)].len == len) &&
+      (reservedWords[RW_HASH(c,len)].str[0] == c) &&
+      (memcmp(s+1,reservedWords[RW_HASH(c,len)].str+1,len-1) == 0))
+    return reservedWords[RW_HASH(c,len)].tok;
+  return ID;
+}
+
+#endif
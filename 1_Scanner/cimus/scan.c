@@ -8,94 +8,72 @@
 #include "globals.h"
 #include "util.h"
 #include "scan.h"
+#include "source.h"
+#include "reserved.h"
+#include "token.h"
+#include "scankern.h"
+#include "parscan.h"
+#include "lineidx.h"
 
 /* states in scanner DFA */
 typedef enum
    { START,INEQ,INCOMMENT,INNUM,INID,DONE,INLT,INGT,INNE,INOVER,INCOMMENT_ }
    StateType;
 
-/* lexeme of identifier or reserved word */
-char tokenString[MAXTOKENLEN+1];
+/* record of the token most recently returned */
+TokenRec tokenRec;
 
-/* BUFLEN = length of the input buffer for
-   source code lines */
-#define BUFLEN 256
-
-static char lineBuf[BUFLEN]; /* holds the current line */
-static int linepos = 0; /* current position in LineBuf */
-static int bufsize = 0; /* current size of buffer string */
+static char * srcPos = NULL; /* next character in srcText */
+static int parallel = FALSE; /* TRUE if parallelToken lexes srcText */
 static int EOF_flag = FALSE; /* corrects ungetNextChar behavior on EOF */
 
-/* getNextChar fetches the next non-blank character
-   from lineBuf, reading in a new line if lineBuf is
-   exhausted */
+/* getNextChar fetches the next character of
+   srcText; the '\0' sentinel following the text
+   marks end of file */
 static int getNextChar(void)
-{ if (!(linepos < bufsize))
-  { lineno++;
-    if (fgets(lineBuf,BUFLEN-1,source))
-    { if (EchoSource) fprintf(listing,"%4d: %s",lineno,lineBuf);
-      bufsize = strlen(lineBuf);
-      linepos = 0;
-      return lineBuf[linepos++];
-    }
-    else
-    { EOF_flag = TRUE;
-      return EOF;
-    }
+{ int c = (unsigned char) *srcPos;
+  if ((c == '\0') && (srcPos == srcText + srcLen))
+  { EOF_flag = TRUE;
+    return EOF;
   }
-  else return lineBuf[linepos++];
+  srcPos++;
+  return c;
 }
 
 /* ungetNextChar backtracks one character
-   in lineBuf */
+   in srcText */
 static void ungetNextChar(void)
-{ if (!EOF_flag) linepos-- ;}
-
-/* lookup table of reserved words */
-static struct
-    { char* str;
-      TokenType tok;
-    } reservedWords[MAXRESERVED]
-   = {{"if",IF},{"else",ELSE},{"while",WHILE},{"return",RETURN},{"int",INT},{"void",VOID},
-      /* discarded */ {"then",THEN},{"end",END},{"repeat",REPEAT},{"until",UNTIL},{"read",READ},{"write",WRITE}
-     };
-
-/* lookup an identifier to see if it is a reserved word */
-/* uses linear search */
-static TokenType reservedLookup (char * s)
-{ int i;
-  for (i=0;i<MAXRESERVED;i++)
-    if (!strcmp(s,reservedWords[i].str))
-      return reservedWords[i].tok;
-  return ID;
+{ if (!EOF_flag) srcPos--;
 }
 
-/****************************************/
-/* the primary function of the scanner  */
-/****************************************/
-/* function getToken returns the 
- * next token in source file
+/* function switchScan scans the next token with
+ * the hand-coded DFA, storing the start of its
+ * lexeme in *startp
  */
-TokenType getToken(void)
-{  /* index for storing into tokenString */
-   int tokenStringIndex = 0;
+static TokenType switchScan(char ** startp)
+{  /* start of the current lexeme in srcText */
+   char * start;
    /* holds current token to be returned */
    TokenType currentToken;
    /* current state - always begins at START */
    StateType state = START;
-   /* flag to indicate save to tokenString */
-   int save;
    while (state != DONE)
-   { int c = getNextChar();
-     save = TRUE;
+   { int c;
+     if (state == START) start = srcPos;
+     c = getNextChar();
      switch (state)
      { case START:
          if (isdigit(c))
-           state = INNUM;
+         { state = INNUM;
+           srcPos = skipDigits(srcPos);
+         }
          else if (isalpha(c))
-           state = INID;
+         { state = INID;
+           srcPos = skipLetters(srcPos);
+         }
          else if ((c == ' ') || (c == '\t') || (c == '\n'))
-           save = FALSE;
+           /* skip whitespace a whole run at a time */
+           srcPos = skipBlanks(srcPos);
          else if (c == '=')
            state = INEQ;
          else if (c == '<')
@@ -105,14 +83,11 @@ TokenType getToken(void)
          else if (c == '!')
            state = INNE;
          else if (c == '/')
-         { save = FALSE;
            state = INOVER;
-         }
          else
          { state = DONE;
            switch (c)
            { case EOF:
-               save = FALSE;
                currentToken = ENDFILE;
                break;
              case '+':
@@ -156,9 +131,7 @@ TokenType getToken(void)
          break;
        case INOVER:
          if(c == '*')
-         { save = FALSE;
            state = INCOMMENT;
-         }
          else
          { state = DONE;
            currentToken = OVER;
@@ -166,22 +139,24 @@ TokenType getToken(void)
          }
          break;
        case INCOMMENT:
-         save = FALSE;
          if (c == EOF)
          { state = DONE;
            currentToken = ENDFILE;
          }
          else if (c == '*') 
            state = INCOMMENT_;
+         else /* jump to the next '*' */
+           srcPos = skipToStar(srcPos);
          break;
        case INCOMMENT_:
-         save = FALSE;
          if (c == EOF)
          { state = DONE;
            currentToken = ENDFILE;
          }
          else if (c == '/')
            state = START;
+         else if (c != '*')
+           state = INCOMMENT;
          break;
        case INEQ:
          state = DONE;
@@ -197,7 +172,6 @@ TokenType getToken(void)
          if (!isdigit(c))
          { /* backup in the input */
            ungetNextChar();
-           save = FALSE;
            state = DONE;
            currentToken = NUM;
          }
@@ -206,7 +180,6 @@ TokenType getToken(void)
          if (!isalpha(c))
          { /* backup in the input */
            ungetNextChar();
-           save = FALSE;
            state = DONE;
            currentToken = ID;
          }
@@ -238,7 +211,6 @@ TokenType getToken(void)
          else
          {
            ungetNextChar();
-           save = FALSE;
            currentToken = ERROR;
          }
          break;
@@ -249,17 +221,222 @@ TokenType getToken(void)
          currentToken = ERROR;
          break;
      }
-     if ((save) && (tokenStringIndex <= MAXTOKENLEN))
-       tokenString[tokenStringIndex++] = (char) c;
-     if (state == DONE)
-     { tokenString[tokenStringIndex] = '\0';
-       if (currentToken == ID)
-         currentToken = reservedLookup(tokenString);
+   }
+   *startp = start;
+   return currentToken;
+}
+
+/**************************************************/
+/*********   Table-driven scanner DFA   ***********/
+/**************************************************/
+
+/* character classes */
+typedef enum
+   { C_OTHER,C_NUL,C_BLANK,C_NL,C_LETTER,C_DIGIT,C_EQ,C_LT,C_GT,C_BANG,
+     C_SLASH,C_STAR,C_PLUS,C_MINUS,C_LPAREN,C_RPAREN,C_LBRACE,C_RBRACE,
+     C_LCURLY,C_RCURLY,C_SEMI,C_COMMA,NCLASS }
+   CharClass;
+
+/* charClass maps every byte to its class; bytes
+   not listed are C_OTHER */
+static const unsigned char charClass[256]
+   = {['\0'] = C_NUL, [' '] = C_BLANK, ['\t'] = C_BLANK, ['\n'] = C_NL,
+      ['a' ... 'z'] = C_LETTER, ['A' ... 'Z'] = C_LETTER,
+      ['0' ... '9'] = C_DIGIT,
+      ['='] = C_EQ, ['<'] = C_LT, ['>'] = C_GT, ['!'] = C_BANG,
+      ['/'] = C_SLASH, ['*'] = C_STAR, ['+'] = C_PLUS, ['-'] = C_MINUS,
+      ['('] = C_LPAREN, [')'] = C_RPAREN, ['['] = C_LBRACE, [']'] = C_RBRACE,
+      ['{'] = C_LCURLY, ['}'] = C_RCURLY, [';'] = C_SEMI, [','] = C_COMMA
+     };
+
+/* table DFA states */
+typedef enum
+   { S_START,S_ID,S_NUM,S_EQ,S_LT,S_GT,S_BANG,S_SLASH,S_COMMENT,S_CSTAR }
+   TableState;
+
+/* final transitions: the token is complete. Each
+   either takes the current character into the
+   lexeme or leaves it as lookahead (finalLen) */
+typedef enum
+   { F_ID,F_NUM,F_ASSIGN,F_EQ,F_LT,F_LE,F_GT,F_GE,F_NE,F_BANG,F_OVER,
+     F_PLUS,F_MINUS,F_TIMES,F_LPAREN,F_RPAREN,F_LBRACE,F_RBRACE,
+     F_LCURLY,F_RCURLY,F_SEMI,F_COMMA,F_ERROR,F_NUL }
+   FinalKind;
+
+static const TokenType finalToken[]
+   = { ID,NUM,ASSIGN,EQ,LT,LE,GT,GE,NE,ERROR,OVER,
+       PLUS,MINUS,TIMES,LPAREN,RPAREN,LBRACE,RBRACE,
+       LCURLY,RCURLY,SEMI,COMMA,ERROR,ENDFILE };
+
+static const unsigned char finalLen[]
+   = { 0,0,0,1,0,1,0,1,1,0,0,
+       1,1,1,1,1,1,1,
+       1,1,1,1,1,0 };
+
+/* A transition is one byte: a final transition has
+   T_FINAL set and the FinalKind below it; any other
+   names the next state and consumes the character */
+#define T_FINAL 0x80
+#define F(k) (T_FINAL|(k))
+
+static const unsigned char dfa[][NCLASS] = {
+/*            OTHER      NUL        BLANK      NL             LETTER     DIGIT      EQ         LT         GT         BANG       SLASH      STAR       PLUS       MINUS       LPAREN      RPAREN      LBRACE      RBRACE      LCURLY      RCURLY      SEMI       COMMA    */
+/* START   */{F(F_ERROR),F(F_NUL),  S_START,   S_START,       S_ID,      S_NUM,     S_EQ,      S_LT,      S_GT,      S_BANG,    S_SLASH,   F(F_TIMES),F(F_PLUS), F(F_MINUS),F(F_LPAREN),F(F_RPAREN),F(F_LBRACE),F(F_RBRACE),F(F_LCURLY),F(F_RCURLY),F(F_SEMI),F(F_COMMA)},
+/* ID      */{F(F_ID),   F(F_ID),   F(F_ID),   F(F_ID),       S_ID,      F(F_ID),   F(F_ID),   F(F_ID),   F(F_ID),   F(F_ID),   F(F_ID),   F(F_ID),   F(F_ID),   F(F_ID),   F(F_ID),    F(F_ID),    F(F_ID),    F(F_ID),    F(F_ID),    F(F_ID),    F(F_ID),   F(F_ID)   },
+/* NUM     */{F(F_NUM),  F(F_NUM),  F(F_NUM),  F(F_NUM),      F(F_NUM),  S_NUM,     F(F_NUM),  F(F_NUM),  F(F_NUM),  F(F_NUM),  F(F_NUM),  F(F_NUM),  F(F_NUM),  F(F_NUM),  F(F_NUM),   F(F_NUM),   F(F_NUM),   F(F_NUM),   F(F_NUM),   F(F_NUM),   F(F_NUM),  F(F_NUM)  },
+/* EQ      */{F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_EQ),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN),F(F_ASSIGN)},
+/* LT      */{F(F_LT),   F(F_LT),   F(F_LT),   F(F_LT),       F(F_LT),   F(F_LT),   F(F_LE),   F(F_LT),   F(F_LT),   F(F_LT),   F(F_LT),   F(F_LT),   F(F_LT),   F(F_LT),   F(F_LT),    F(F_LT),    F(F_LT),    F(F_LT),    F(F_LT),    F(F_LT),    F(F_LT),   F(F_LT)   },
+/* GT      */{F(F_GT),   F(F_GT),   F(F_GT),   F(F_GT),       F(F_GT),   F(F_GT),   F(F_GE),   F(F_GT),   F(F_GT),   F(F_GT),   F(F_GT),   F(F_GT),   F(F_GT),   F(F_GT),   F(F_GT),    F(F_GT),    F(F_GT),    F(F_GT),    F(F_GT),    F(F_GT),    F(F_GT),   F(F_GT)   },
+/* BANG    */{F(F_BANG), F(F_BANG), F(F_BANG), F(F_BANG),     F(F_BANG), F(F_BANG), F(F_NE),   F(F_BANG), F(F_BANG), F(F_BANG), F(F_BANG), F(F_BANG), F(F_BANG), F(F_BANG), F(F_BANG),  F(F_BANG),  F(F_BANG),  F(F_BANG),  F(F_BANG),  F(F_BANG),  F(F_BANG), F(F_BANG) },
+/* SLASH   */{F(F_OVER), F(F_OVER), F(F_OVER), F(F_OVER),     F(F_OVER), F(F_OVER), F(F_OVER), F(F_OVER), F(F_OVER), F(F_OVER), F(F_OVER), S_COMMENT, F(F_OVER), F(F_OVER), F(F_OVER),  F(F_OVER),  F(F_OVER),  F(F_OVER),  F(F_OVER),  F(F_OVER),  F(F_OVER), F(F_OVER) },
+/* COMMENT */{S_COMMENT, F(F_NUL),  S_COMMENT, S_COMMENT,     S_COMMENT, S_COMMENT, S_COMMENT, S_COMMENT, S_COMMENT, S_COMMENT, S_COMMENT, S_CSTAR,   S_COMMENT, S_COMMENT, S_COMMENT,  S_COMMENT,  S_COMMENT,  S_COMMENT,  S_COMMENT,  S_COMMENT,  S_COMMENT, S_COMMENT },
+/* CSTAR   */{S_COMMENT, F(F_NUL),  S_COMMENT, S_COMMENT,     S_COMMENT, S_COMMENT, S_COMMENT, S_COMMENT, S_COMMENT, S_COMMENT, S_START,   S_CSTAR,   S_COMMENT, S_COMMENT, S_COMMENT,  S_COMMENT,  S_COMMENT,  S_COMMENT,  S_COMMENT,  S_COMMENT,  S_COMMENT, S_COMMENT }
+};
+
+/* start and number of the first line not yet echoed */
+static char * echoPos = NULL;
+static int echoLine = 1;
+
+/* echoLines echoes each source line that
+   begins before p and has not been echoed */
+static void echoLines(char * p)
+{ char * end = srcText + srcLen;
+  if (echoPos == NULL) echoPos = srcText;
+  while (echoPos < p)
+  { char * eol = memchr(echoPos,'\n',end-echoPos);
+    char * next = (eol != NULL) ? eol+1 : end;
+    fprintf(listing,"%4d: %.*s",echoLine++,(int) (next-echoPos),echoPos);
+    echoPos = next;
+  }
+}
+
+/* function dfaScan runs the table-driven DFA from
+ * *pp to the end of the next token, or to end, the
+ * end of the text being scanned. It stores the
+ * start of the lexeme in *startp and leaves *pp
+ * just after it. Each character costs a class
+ * lookup and a
+ * transition lookup; only the START state, entered
+ * between tokens, checks for end
+ */
+static TokenType dfaScan(unsigned char ** pp, unsigned char * end,
+                         unsigned char ** startp)
+{ unsigned char * p = *pp;
+  unsigned char * start = p;
+  int state = S_START;
+  int t;
+  FinalKind f = F_NUL;
+  if (p != end)
+    for (;;)
+    { t = dfa[state][charClass[*p]];
+      if (t & T_FINAL)
+      { f = (FinalKind) (t & ~T_FINAL);
+        if (f != F_NUL) break;
+        if (p == end) break;
+        /* a '\0' inside the text: an error token,
+           or part of a comment */
+        if ((state != S_COMMENT) && (state != S_CSTAR))
+        { f = F_ERROR;
+          break;
+        }
+        t = S_COMMENT;
+      }
+      p++;
+      state = t;
+      if (state == S_START)
+      { start = p;
+        if (p == end)
+        { f = F_NUL;
+          break;
+        }
+      }
+    }
+  if (f == F_NUL) start = p; /* end of text, possibly inside a comment */
+  else p += finalLen[f];
+  *pp = p;
+  *startp = start;
+  return finalToken[f];
+}
+
+/* function tableScan scans the next token of
+ * srcText with dfaScan, storing the start of its
+ * lexeme in *startp
+ */
+static TokenType tableScan(char ** startp)
+{ unsigned char * p = (unsigned char *) srcPos;
+  unsigned char * start;
+  TokenType currentToken;
+  currentToken = dfaScan(&p,(unsigned char *) srcText + srcLen,&start);
+  srcPos = (char *) p;
+  *startp = (char *) start;
+  return currentToken;
+}
+
+/* Function scanChunk appends the tokens of the text
+ * from begin up to end to ts, lexing them with the
+ * table-driven DFA
+ */
+int scanChunk( char * begin, char * end, TokenStream * ts )
+{ unsigned char * p = (unsigned char *) begin;
+  unsigned char * start;
+  TokenRec tok;
+  for (;;)
+  { tok.kind = dfaScan(&p,(unsigned char *) end,&start);
+    if (tok.kind == ENDFILE) break;
+    tok.length = (int) (p-start);
+    if (tok.kind == ID)
+      tok.kind = reservedLookup((char *) start,tok.length);
+    tok.offset = (int) ((char *) start-srcText);
+    if (!appendToken(ts,&tok)) return FALSE;
+  }
+  return TRUE;
+}
+
+/****************************************/
+/* the primary function of the scanner  */
+/****************************************/
+/* function getToken returns the 
+ * next token in source file
+ */
+TokenType getToken(void)
+{  /* start of the current lexeme in srcText */
+   char * start;
+   /* holds current token to be returned */
+   TokenType currentToken;
+   if (srcPos == NULL)
+   { if (!mapSource(source) || !buildLineIndex())
+     { Error = TRUE;
+       return ENDFILE;
+     }
+     srcPos = srcText;
+     initScanKernels();
+     parallel = (scanThreads() > 1);
+   }
+   if (parallel)
+   { currentToken = parallelToken();
+     if (EchoSource && !Error)
+       echoLines(srcText+tokenRec.offset+tokenRec.length);
+     if (TraceScan) {
+       fprintf(listing,"\t%d: ",tokenLine(&tokenRec));
+       printTokenRec(&tokenRec);
      }
+     return currentToken;
    }
+   if (TableScan)
+     currentToken = tableScan(&start);
+   else
+     currentToken = switchScan(&start);
+   if (currentToken == ID)
+     currentToken = reservedLookup(start,(int) (srcPos-start));
+   else if (currentToken == ENDFILE) /* possibly inside a comment */
+     start = srcPos;
+   tokenRec.kind = currentToken;
+   tokenRec.offset = (int) (start-srcText);
+   tokenRec.length = (int) (srcPos-start);
+   if (EchoSource) echoLines(srcPos);
    if (TraceScan) {
-     fprintf(listing,"\t%d: ",lineno);
-     printToken(currentToken,tokenString);
+     fprintf(listing,"\t%d: ",tokenLine(&tokenRec));
+     printTokenRec(&tokenRec);
    }
    return currentToken;
 } /* end getToken */
@@ -8,11 +8,21 @@
 #ifndef _SCAN_H_
 #define _SCAN_H_
 
-/* MAXTOKENLEN is the maximum size of a token */
-#define MAXTOKENLEN 40
+/* TokenRec describes a token by the position of
+ * its lexeme in srcText (see source.h) instead of
+ * by a copy of it; use the functions in token.h
+ * to get at the lexeme itself
+ */
+typedef struct
+   { TokenType kind;
+     int offset; /* byte offset of the lexeme in srcText */
+     int length; /* length of the lexeme in bytes */
+   } TokenRec;
 
-/* tokenString array stores the lexeme of each token */
-extern char tokenString[MAXTOKENLEN+1];
+/* tokenRec describes the token most
+ * recently returned by getToken
+ */
+extern TokenRec tokenRec;
 
 /* function getToken returns the 
  * next token in source file
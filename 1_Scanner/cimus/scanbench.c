@@ -0,0 +1,88 @@
+/****************************************************/
+/* File: scanbench.c                                */
+/* Throughput benchmark driver for the C-Minus      */
+/* scanners: linked with scan.o it measures the     */
+/* hand-written scanner, with lex.yy.o the flex one */
+/****************************************************/
+
+#include <time.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include "globals.h"
+#include "util.h"
+#include "scan.h"
+#include "source.h"
+#include "token.h"
+
+/* allocate global variables */
+FILE * source;
+FILE * listing;
+FILE * code;
+
+/* allocate and set tracing flags: the benchmark
+   always scans with tracing off */
+int EchoSource = FALSE;
+int TraceScan = FALSE;
+int MapSource = TRUE;
+int TableScan = FALSE;
+int ScanThreads = 1;
+int TraceParse = FALSE;
+int TraceAnalyze = FALSE;
+int TraceCode = FALSE;
+
+int Error = FALSE;
+
+static void usage( char * pgm )
+{ fprintf(stderr,"usage: %s [-d] [-t] [-j threads] <filename>\n",pgm);
+  fprintf(stderr,"  -d  dump the token stream instead of timing it\n");
+  fprintf(stderr,"  -t  use the table-driven DFA (scan.c only)\n");
+  fprintf(stderr,"  -j  lex in parallel chunks on that many threads (0: one per processor)\n");
+  exit(1);
+}
+
+int main( int argc, char * argv[] )
+{ int dump = FALSE;
+  long count = 0;
+  struct timespec t0, t1;
+  struct rusage ru;
+  double secs;
+  TokenType t;
+  int i;
+  for (i=1;(i<argc) && (argv[i][0]=='-');i++)
+    if (strcmp(argv[i],"-d") == 0) dump = TRUE;
+    else if (strcmp(argv[i],"-t") == 0) TableScan = TRUE;
+    else if ((strcmp(argv[i],"-j") == 0) && (i+1 < argc)) ScanThreads = atoi(argv[++i]);
+    else usage(argv[0]);
+  if (i != argc-1) usage(argv[0]);
+  source = fopen(argv[i],"r");
+  if (source==NULL)
+  { fprintf(stderr,"File %s not found\n",argv[i]);
+    exit(1);
+  }
+  listing = stdout;
+  clock_gettime(CLOCK_MONOTONIC,&t0);
+  do
+  { t = getToken();
+    count++;
+    if (dump)
+    { fprintf(listing,"\t%d: ",tokenLine(&tokenRec));
+      printTokenRec(&tokenRec);
+    }
+  } while (t != ENDFILE);
+  clock_gettime(CLOCK_MONOTONIC,&t1);
+  if (Error)
+  { fprintf(stderr,"%s: could not scan %s\n",argv[0],argv[i]);
+    exit(1);
+  }
+  if (!dump)
+  { getrusage(RUSAGE_SELF,&ru);
+    secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    if (secs <= 0) secs = 1e-9;
+    fprintf(listing,"%10ld tokens %8.2f MB %8.3f s %12.0f tokens/sec %8.1f MB/sec %8ld KB peak RSS\n",
+            count, srcLen / 1048576.0, secs, count / secs,
+            srcLen / 1048576.0 / secs, (long) ru.ru_maxrss);
+  }
+  unmapSource();
+  fclose(source);
+  return 0;
+}
@@ -0,0 +1,219 @@
+/****************************************************/
+/* File: scangen.c                                  */
+/* Synthetic C-Minus source generator for the       */
+/* scanner benchmark                                */
+/****************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* MAXDEPTH = deepest statement nesting generated,
+   MAXPAREN = deepest expression nesting generated */
+#define MAXDEPTH 48
+#define MAXPAREN 24
+
+/* the token mixes the generator can produce */
+typedef enum {COMMENT,IDENT,NESTED,MIXED} Mix;
+
+static const char * mixName[] = {"comment","ident","nested","mixed"};
+
+static Mix mix;
+
+/* number of bytes written so far */
+static long written = 0;
+
+/* state of the pseudo-random generator; the same
+   seed always yields the same program */
+static unsigned long long seed = 1;
+
+/* rnd returns a pseudo-random number in [0,n) */
+static int rnd( int n )
+{ seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (int) ((seed >> 33) % (unsigned long long) n);
+}
+
+static void emit( const char * s )
+{ fputs(s,stdout);
+  written += strlen(s);
+}
+
+static void indent( int depth )
+{ int i;
+  for (i=0;i<depth;i++) emit((rnd(4)==0) ? "\t" : "  ");
+}
+
+/* genIdent writes an identifier; the identifier-heavy
+   mix uses long ones */
+static void genIdent( void )
+{ char buf[40];
+  int len = (mix == IDENT) ? 4 + rnd(28) : 1 + rnd(8);
+  int i;
+  for (i=0;i<len;i++)
+  { int c = rnd(52);
+    buf[i] = (c < 26) ? 'a' + c : 'A' + c - 26;
+  }
+  buf[len] = '\0';
+  emit(buf);
+}
+
+static void genNum( void )
+{ char buf[16];
+  sprintf(buf,"%d",rnd(100000));
+  emit(buf);
+}
+
+/* genComment writes a block comment of a few lines,
+   with stray '*' and '/' characters that must not
+   end it early */
+static void genComment( int depth )
+{ static const char * words[] =
+    {"the","loop","counts","down","*","**","/","index","/**",
+     "array","bound","is","checked","here","/ *","x*y"};
+  int lines = 1 + rnd(12);
+  int i, j;
+  indent(depth);
+  emit("/*");
+  for (i=0;i<lines;i++)
+  { int n = 3 + rnd(10);
+    for (j=0;j<n;j++)
+    { emit(" ");
+      emit(words[rnd(sizeof(words)/sizeof(words[0]))]);
+    }
+    if (i < lines-1)
+    { emit("\n");
+      indent(depth);
+      emit(" *");
+    }
+  }
+  emit(" */\n");
+}
+
+/* genExp writes an expression with up to paren
+   levels of nested parentheses; the deeply nested
+   mix always opens a new level on the first term
+   and on no other, so its expressions grow only
+   linearly with the depth */
+static void genExp( int paren )
+{ static const char * ops[] =
+    {" + "," - "," * "," / "," < "," <= "," > "," >= "," == "," != "};
+  int n = 1 + rnd(3);
+  int i;
+  for (i=0;i<n;i++)
+  { if (i > 0) emit(ops[rnd(10)]);
+    if ((paren > 0) && ((mix == NESTED) ? (i == 0) : (rnd(3) == 0)))
+    { emit("(");
+      genExp(paren-1);
+      emit(")");
+    }
+    else if (rnd(3) == 0) genNum();
+    else
+    { genIdent();
+      if (rnd(5) == 0)
+      { emit("[");
+        genExp(((mix == NESTED) || (paren == 0)) ? 0 : paren-1);
+        emit("]");
+      }
+    }
+  }
+}
+
+/* genStmt writes a statement, nesting if and while
+   statements up to depth levels deep */
+static void genStmt( int depth, int level )
+{ int paren = (mix == NESTED) ? MAXPAREN : 2;
+  int kind;
+  if ((mix == COMMENT) || ((mix == MIXED) && (rnd(4) == 0)))
+    genComment(level);
+  indent(level);
+  if (depth == 0) kind = rnd(3);
+  else if ((mix == NESTED) && (rnd(4) > 0)) kind = 3;
+  else kind = rnd(5);
+  switch (kind)
+  { case 0:
+      genIdent();
+      emit(" = ");
+      genExp(paren);
+      emit(";\n");
+      break;
+    case 1:
+      genIdent();
+      emit("(");
+      genExp(paren);
+      emit(", ");
+      genExp(paren);
+      emit(");\n");
+      break;
+    case 2:
+      emit("return ");
+      genExp(paren);
+      emit(";\n");
+      break;
+    case 3:
+    case 4:
+    { int n = (mix == NESTED) ? 1 : 1 + rnd(3);
+      int i;
+      emit(rnd(2) ? "if (" : "while (");
+      genExp(paren);
+      emit(") {\n");
+      for (i=0;i<n;i++) genStmt(depth-1,level+1);
+      indent(level);
+      emit("}\n");
+      if (rnd(3) == 0)
+      { indent(level);
+        emit("else {\n");
+        genStmt(0,level+1);
+        indent(level);
+        emit("}\n");
+      }
+      break;
+    }
+  }
+}
+
+/* genFun writes one function declaration */
+static void genFun( void )
+{ int depth = (mix == NESTED) ? MAXDEPTH : 3;
+  int n = 2 + rnd(8);
+  int i;
+  if (mix == COMMENT) genComment(0);
+  emit(rnd(2) ? "int " : "void ");
+  genIdent();
+  emit("(int ");
+  genIdent();
+  emit(", int ");
+  genIdent();
+  emit("[])\n{\n");
+  for (i=rnd(4);i>0;i--)
+  { emit("  int ");
+    genIdent();
+    if (rnd(3) == 0)
+    { emit("[");
+      genNum();
+      emit("]");
+    }
+    emit(";\n");
+  }
+  for (i=0;i<n;i++) genStmt(depth,1);
+  emit("}\n\n");
+}
+
+int main( int argc, char * argv[] )
+{ long size;
+  int i;
+  if ((argc < 3) || (argc > 4))
+  { fprintf(stderr,"usage: %s comment|ident|nested|mixed <kbytes> [seed]\n",argv[0]);
+    exit(1);
+  }
+  for (i=0;i<4;i++)
+    if (strcmp(argv[1],mixName[i]) == 0) break;
+  if (i == 4)
+  { fprintf(stderr,"%s: unknown mix %s\n",argv[0],argv[1]);
+    exit(1);
+  }
+  mix = (Mix) i;
+  size = atol(argv[2]) * 1024;
+  if (argc == 4) seed = strtoull(argv[3],NULL,10);
+  while (written < size) genFun();
+  return 0;
+}
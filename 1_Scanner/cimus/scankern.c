@@ -0,0 +1,221 @@
+/****************************************************/
+/* File: scankern.c                                 */
+/* Vectorised character-run kernels for the         */
+/* C-Minus scanners                                 */
+/****************************************************/
+
+#include <stdint.h>
+#include "globals.h"
+#include "scankern.h"
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+/**************************************************/
+/***********   Plain C kernels         ************/
+/**************************************************/
+
+static char * skipBlanksC( char * p )
+{ while ((*p == ' ') || (*p == '\t') || (*p == '\n')) p++;
+  return p;
+}
+
+static char * skipLettersC( char * p )
+{ while ((unsigned) ((*p | 0x20) - 'a') < 26) p++;
+  return p;
+}
+
+static char * skipDigitsC( char * p )
+{ while ((unsigned) (*p - '0') < 10) p++;
+  return p;
+}
+
+static char * skipToStarC( char * p )
+{ while ((*p != '*') && (*p != '\0')) p++;
+  return p;
+}
+
+#ifdef SCAN_X86
+
+/**************************************************/
+/***********   SSE2 kernels (16 bytes) ************/
+/**************************************************/
+
+/* each kernel starts at the aligned block holding p,
+ * with keep masking off the bytes before p, and stops
+ * in the first block holding a byte outside its class
+ */
+
+static char * skipBlanksSSE2( char * p )
+{ const __m128i sp = _mm_set1_epi8(' ');
+  const __m128i tab = _mm_set1_epi8('\t');
+  const __m128i nl = _mm_set1_epi8('\n');
+  unsigned int off = (unsigned int) ((uintptr_t) p & 15);
+  const char * b = p - off;
+  unsigned int keep = 0xFFFFu << off;
+  for (;;)
+  { __m128i v = _mm_load_si128((const __m128i *) b);
+    unsigned int blank = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v,nl),
+                           _mm_or_si128(_mm_cmpeq_epi8(v,sp),_mm_cmpeq_epi8(v,tab))));
+    unsigned int stop = ~blank & keep;
+    if (stop) return (char *) b + __builtin_ctz(stop);
+    keep = 0xFFFFu;
+    b += 16;
+  }
+}
+
+static char * skipLettersSSE2( char * p )
+{ const __m128i fold = _mm_set1_epi8(0x20);
+  const __m128i bias = _mm_set1_epi8((char) (0x80-'a'));
+  const __m128i limit = _mm_set1_epi8((char) (-128+26));
+  unsigned int off = (unsigned int) ((uintptr_t) p & 15);
+  const char * b = p - off;
+  unsigned int keep = 0xFFFFu << off;
+  for (;;)
+  { __m128i v = _mm_load_si128((const __m128i *) b);
+    __m128i t = _mm_add_epi8(_mm_or_si128(v,fold),bias);
+    unsigned int stop = ~_mm_movemask_epi8(_mm_cmplt_epi8(t,limit)) & keep;
+    if (stop) return (char *) b + __builtin_ctz(stop);
+    keep = 0xFFFFu;
+    b += 16;
+  }
+}
+
+static char * skipDigitsSSE2( char * p )
+{ const __m128i bias = _mm_set1_epi8((char) (0x80-'0'));
+  const __m128i limit = _mm_set1_epi8((char) (-128+10));
+  unsigned int off = (unsigned int) ((uintptr_t) p & 15);
+  const char * b = p - off;
+  unsigned int keep = 0xFFFFu << off;
+  for (;;)
+  { __m128i v = _mm_load_si128((const __m128i *) b);
+    __m128i t = _mm_add_epi8(v,bias);
+    unsigned int stop = ~_mm_movemask_epi8(_mm_cmplt_epi8(t,limit)) & keep;
+    if (stop) return (char *) b + __builtin_ctz(stop);
+    keep = 0xFFFFu;
+    b += 16;
+  }
+}
+
+static char * skipToStarSSE2( char * p )
+{ const __m128i star = _mm_set1_epi8('*');
+  const __m128i nul = _mm_setzero_si128();
+  unsigned int off = (unsigned int) ((uintptr_t) p & 15);
+  const char * b = p - off;
+  unsigned int keep = 0xFFFFu << off;
+  for (;;)
+  { __m128i v = _mm_load_si128((const __m128i *) b);
+    unsigned int stop = _mm_movemask_epi8(_mm_or_si128(
+                          _mm_cmpeq_epi8(v,star),_mm_cmpeq_epi8(v,nul))) & keep;
+    if (stop) return (char *) b + __builtin_ctz(stop);
+    keep = 0xFFFFu;
+    b += 16;
+  }
+}
+
+/**************************************************/
+/***********   AVX2 kernels (32 bytes) ************/
+/**************************************************/
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static char * skipBlanksAVX2( char * p )
+{ const __m256i sp = _mm256_set1_epi8(' ');
+  const __m256i tab = _mm256_set1_epi8('\t');
+  const __m256i nl = _mm256_set1_epi8('\n');
+  unsigned int off = (unsigned int) ((uintptr_t) p & 31);
+  const char * b = p - off;
+  unsigned int keep = 0xFFFFFFFFu << off;
+  for (;;)
+  { __m256i v = _mm256_load_si256((const __m256i *) b);
+    unsigned int blank = (unsigned int) _mm256_movemask_epi8(_mm256_or_si256(
+                           _mm256_cmpeq_epi8(v,nl),_mm256_or_si256(
+                           _mm256_cmpeq_epi8(v,sp),_mm256_cmpeq_epi8(v,tab))));
+    unsigned int stop = ~blank & keep;
+    if (stop) return (char *) b + __builtin_ctz(stop);
+    keep = 0xFFFFFFFFu;
+    b += 32;
+  }
+}
+
+AVX2 static char * skipLettersAVX2( char * p )
+{ const __m256i fold = _mm256_set1_epi8(0x20);
+  const __m256i bias = _mm256_set1_epi8((char) (0x80-'a'));
+  const __m256i limit = _mm256_set1_epi8((char) (-128+26));
+  unsigned int off = (unsigned int) ((uintptr_t) p & 31);
+  const char * b = p - off;
+  unsigned int keep = 0xFFFFFFFFu << off;
+  for (;;)
+  { __m256i v = _mm256_load_si256((const __m256i *) b);
+    __m256i t = _mm256_add_epi8(_mm256_or_si256(v,fold),bias);
+    unsigned int stop = ~(unsigned int) _mm256_movemask_epi8(
+                          _mm256_cmpgt_epi8(limit,t)) & keep;
+    if (stop) return (char *) b + __builtin_ctz(stop);
+    keep = 0xFFFFFFFFu;
+    b += 32;
+  }
+}
+
+AVX2 static char * skipDigitsAVX2( char * p )
+{ const __m256i bias = _mm256_set1_epi8((char) (0x80-'0'));
+  const __m256i limit = _mm256_set1_epi8((char) (-128+10));
+  unsigned int off = (unsigned int) ((uintptr_t) p & 31);
+  const char * b = p - off;
+  unsigned int keep = 0xFFFFFFFFu << off;
+  for (;;)
+  { __m256i v = _mm256_load_si256((const __m256i *) b);
+    __m256i t = _mm256_add_epi8(v,bias);
+    unsigned int stop = ~(unsigned int) _mm256_movemask_epi8(
+                          _mm256_cmpgt_epi8(limit,t)) & keep;
+    if (stop) return (char *) b + __builtin_ctz(stop);
+    keep = 0xFFFFFFFFu;
+    b += 32;
+  }
+}
+
+AVX2 static char * skipToStarAVX2( char * p )
+{ const __m256i star = _mm256_set1_epi8('*');
+  const __m256i nul = _mm256_setzero_si256();
+  unsigned int off = (unsigned int) ((uintptr_t) p & 31);
+  const char * b = p - off;
+  unsigned int keep = 0xFFFFFFFFu << off;
+  for (;;)
+  { __m256i v = _mm256_load_si256((const __m256i *) b);
+    unsigned int stop = (unsigned int) _mm256_movemask_epi8(_mm256_or_si256(
+                          _mm256_cmpeq_epi8(v,star),_mm256_cmpeq_epi8(v,nul))) & keep;
+    if (stop) return (char *) b + __builtin_ctz(stop);
+    keep = 0xFFFFFFFFu;
+    b += 32;
+  }
+}
+
+#endif /* SCAN_X86 */
+
+char * (*skipBlanks)( char * ) = skipBlanksC;
+char * (*skipLetters)( char * ) = skipLettersC;
+char * (*skipDigits)( char * ) = skipDigitsC;
+char * (*skipToStar)( char * ) = skipToStarC;
+
+/* Procedure initScanKernels selects the widest
+ * kernels the running CPU supports
+ */
+void initScanKernels( void )
+{
+#ifdef SCAN_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2"))
+  { skipBlanks = skipBlanksAVX2;
+    skipLetters = skipLettersAVX2;
+    skipDigits = skipDigitsAVX2;
+    skipToStar = skipToStarAVX2;
+  }
+  else
+  { skipBlanks = skipBlanksSSE2;
+    skipLetters = skipLettersSSE2;
+    skipDigits = skipDigitsSSE2;
+    skipToStar = skipToStarSSE2;
+  }
+#endif
+}
@@ -0,0 +1,41 @@
+/****************************************************/
+/* File: scankern.h                                 */
+/* Vectorised character-run kernels for the         */
+/* C-Minus scanners                                 */
+/****************************************************/
+
+#ifndef _SCANKERN_H_
+#define _SCANKERN_H_
+
+/* Each kernel scans forward from p over a run of one
+ * character class and returns a pointer to the first
+ * character outside it. The run never extends past
+ * the '\0' sentinel that ends srcText (see source.h).
+ * The kernels read whole aligned 16 or 32 byte blocks
+ * and so may look at bytes on either side of the run,
+ * but never outside the memory page holding them.
+ * None of them counts newlines: line numbers come
+ * from the index in lineidx.h
+ */
+
+/* skipBlanks skips spaces, tabs and newlines */
+extern char * (*skipBlanks)( char * p );
+
+/* skipLetters skips the letters [A-Za-z] */
+extern char * (*skipLetters)( char * p );
+
+/* skipDigits skips the digits [0-9] */
+extern char * (*skipDigits)( char * p );
+
+/* skipToStar skips to the next '*' (or the sentinel)
+ * inside a comment
+ */
+extern char * (*skipToStar)( char * p );
+
+/* Procedure initScanKernels selects the widest
+ * kernels the running CPU supports (AVX2, SSE2 or
+ * plain C); it must be called before any of them
+ */
+void initScanKernels( void );
+
+#endif
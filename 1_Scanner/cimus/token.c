@@ -0,0 +1,91 @@
+/****************************************************/
+/* File: token.c                                    */
+/* Token stream implementation shared by the        */
+/* hand-written and flex scanners                   */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "scan.h"
+#include "source.h"
+#include "token.h"
+#include "lineidx.h"
+
+/* Function tokenLexeme returns a newly allocated,
+ * null-terminated copy of the lexeme of tok
+ */
+char * tokenLexeme( const TokenRec * tok )
+{ char * t = (char *) malloc(tok->length+1);
+  if (t==NULL)
+    fprintf(listing,"Out of memory error at line %d\n",tokenLine(tok));
+  else
+  { memcpy(t,srcText+tok->offset,tok->length);
+    t[tok->length] = '\0';
+  }
+  return t;
+}
+
+/* Function tokenValue returns the value of
+ * a NUM token without copying its lexeme
+ */
+int tokenValue( const TokenRec * tok )
+{ const char * s = srcText + tok->offset;
+  int val = 0;
+  int i;
+  for (i=0;i<tok->length;i++)
+    val = val*10 + (s[i]-'0');
+  return val;
+}
+
+/* Function tokenLine returns the source line
+ * tok ends on
+ */
+int tokenLine( const TokenRec * tok )
+{ return lineOf(tok->offset + tok->length - (tok->length > 0));
+}
+
+/* Procedure printTokenRec prints tok and its
+ * lexeme to the listing file
+ */
+void printTokenRec( const TokenRec * tok )
+{ char * s = tokenLexeme(tok);
+  printToken(tok->kind,(s!=NULL) ? s : "");
+  free(s);
+}
+
+/* Function appendToken appends a copy of tok
+ * to ts, growing it as needed
+ */
+int appendToken( TokenStream * ts, const TokenRec * tok )
+{ if (ts->count == ts->capacity)
+  { int cap = (ts->capacity > 0) ? ts->capacity*2 : 1024;
+    TokenRec * p = (TokenRec *) realloc(ts->tok,cap*sizeof(TokenRec));
+    if (p==NULL)
+    { fprintf(listing,"Out of memory error at line %d\n",tokenLine(tok));
+      return FALSE;
+    }
+    ts->tok = p;
+    ts->capacity = cap;
+  }
+  ts->tok[ts->count++] = *tok;
+  return TRUE;
+}
+
+/* Function scanTokens calls getToken until end of
+ * file, appending each token record to ts
+ */
+int scanTokens( TokenStream * ts )
+{ TokenType t;
+  do
+  { t = getToken();
+    if (!appendToken(ts,&tokenRec)) break;
+  } while (t != ENDFILE);
+  return ts->count;
+}
+
+/* Procedure freeTokens releases the records of ts */
+void freeTokens( TokenStream * ts )
+{ free(ts->tok);
+  ts->tok = NULL;
+  ts->count = ts->capacity = 0;
+}
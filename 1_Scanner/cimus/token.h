@@ -0,0 +1,54 @@
+/****************************************************/
+/* File: token.h                                    */
+/* Token stream interface shared by the             */
+/* hand-written and flex scanners                   */
+/****************************************************/
+
+#ifndef _TOKEN_H_
+#define _TOKEN_H_
+
+/* TokenStream is a growable array of token records
+ * in source order, ending with the ENDFILE token
+ */
+typedef struct
+   { TokenRec * tok;
+     int count;
+     int capacity;
+   } TokenStream;
+
+/* Function tokenLexeme returns a newly allocated,
+ * null-terminated copy of the lexeme of tok
+ */
+char * tokenLexeme( const TokenRec * tok );
+
+/* Function tokenValue returns the value of
+ * a NUM token without copying its lexeme
+ */
+int tokenValue( const TokenRec * tok );
+
+/* Function tokenLine returns the source line
+ * tok ends on, from the index in lineidx.h
+ */
+int tokenLine( const TokenRec * tok );
+
+/* Procedure printTokenRec prints tok and its
+ * lexeme to the listing file
+ */
+void printTokenRec( const TokenRec * tok );
+
+/* Function appendToken appends a copy of tok to
+ * ts, growing it as needed; returns FALSE if it
+ * runs out of memory
+ */
+int appendToken( TokenStream * ts, const TokenRec * tok );
+
+/* Function scanTokens calls getToken until end of
+ * file, appending each token record to ts; returns
+ * the number of tokens in ts
+ */
+int scanTokens( TokenStream * ts );
+
+/* Procedure freeTokens releases the records of ts */
+void freeTokens( TokenStream * ts );
+
+#endif
@@ -8,6 +8,8 @@
 
 #include "globals.h"
 #include "util.h"
+#include "scan.h"
+#include "token.h"
 
 /* Procedure printToken prints a token 
  * and its lexeme to the listing file
@@ -67,13 +69,13 @@ TreeNode * newStmtNode(StmtKind kind)
 { TreeNode * t = (TreeNode *) malloc(sizeof(TreeNode));
   int i;
   if (t==NULL)
-    fprintf(listing,"Out of memory error at line %d\n",lineno);
+    fprintf(listing,"Out of memory error at line %d\n",tokenLine(&tokenRec));
   else {
     for (i=0;i<MAXCHILDREN;i++) t->child[i] = NULL;
     t->sibling = NULL;
     t->nodekind = StmtK;
     t->kind.stmt = kind;
-    t->lineno = lineno;
+    t->offset = -1;
   }
   return t;
 }
@@ -85,13 +87,13 @@ TreeNode * newExpNode(ExpKind kind)
 { TreeNode * t = (TreeNode *) malloc(sizeof(TreeNode));
   int i;
   if (t==NULL)
-    fprintf(listing,"Out of memory error at line %d\n",lineno);
+    fprintf(listing,"Out of memory error at line %d\n",tokenLine(&tokenRec));
   else {
     for (i=0;i<MAXCHILDREN;i++) t->child[i] = NULL;
     t->sibling = NULL;
     t->nodekind = ExpK;
     t->kind.exp = kind;
-    t->lineno = lineno;
+    t->offset = -1;
     t->type = Void;
   }
   return t;
@@ -107,7 +109,7 @@ char * copyString(char * s)
   n = strlen(s)+1;
   t = malloc(n);
   if (t==NULL)
-    fprintf(listing,"Out of memory error at line %d\n",lineno);
+    fprintf(listing,"Out of memory error at line %d\n",tokenLine(&tokenRec));
   else strcpy(t,s);
   return t;
 }
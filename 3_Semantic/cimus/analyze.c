@@ -10,87 +10,69 @@
 #include "symtab.h"
 #include "analyze.h"
 #include "util.h"
+#include "walk.h"
+#include "intern.h"
+#include "lineidx.h"
 
 static Scope globalScope;
 static Scope curScope;
 static Bucket curBucket;
+static Bucket declBucket; /* the declaration a name resolves to */
 static char *name;
 static char errorMsg[100];
 
-/* Procedure traverse is a generic recursive 
- * syntax tree traversal routine:
- * it applies preProc in preorder and postProc 
- * in postorder to tree pointed to by t
- */
-static void traverse( TreeNode * t,
-               void (* preProc) (TreeNode *),
-               void (* postProc) (TreeNode *) )
-{ if (t != NULL)
-  { preProc(t);
-    { int i;
-      for (i=0; i < MAXCHILDREN; i++)
-        traverse(t->child[i],preProc,postProc);
-    }
-    postProc(t);
-    traverse(t->sibling,preProc,postProc);
-  }
-}
-
-/* nullProc is a do-nothing procedure to 
- * generate preorder-only or postorder-only
- * traversals from traverse
- */
-static void nullProc(TreeNode * t)
-{ if (t==NULL) return;
-  else return;
-}
-
 /* print received error message and exit the program */
 static void buildingError(TreeNode *t, char *message)
 {
-  fprintf(listing,"Error: %s at line %d\n", message, t->lineno);
+  fprintf(listing,"Error: %s at line %d\n", message, lineOf(t->offset));
   Error = TRUE;
 }
 
-/* Procedure insertNode inserts
+/* Function insertNode inserts
  * identifiers stored in t into
- * the symbol table
+ * the symbol table; all the children
+ * of t are visited after it. The scopes
+ * open are those around t, so a name is
+ * resolved by its innermost binding
  */
-static void insertNode(TreeNode *t)
+static int insertNode(WalkFrame *f)
 {
+  NodeId n = f->node;
+  TreeNode *t = node(n);
   curScope = sc_top();
-  t->scope = curScope;
+  setNodeScope(n, curScope);
   switch (t->nodekind) {
     case StmtK:
       switch (t->kind.stmt) {
         case FunK:
           name = t->attr.name;
-          if (st_lookup(curScope, name) != NULL) {
+          if (st_bound(name) != NULL) {
             strcpy(errorMsg, "Redefinition of Function ");
             buildingError(t, strcat(errorMsg, name));
           }
           if (curScope != globalScope) {
             buildingError(t, "Function Definition is not allowed here");
           }
-          if(!strcmp(t->attr.type, "int"))	t->type = Integer;
-          else if(!strcmp(t->attr.type, "void"))	t->type = Void;
+          if(t->decl == Integer)	t->type = Integer;
+          else if(t->decl == Void)	t->type = Void;
           
-          st_insert(curScope, name, t, t->type, t->lineno, nextLocation(curScope));
+          curBucket = st_insert(curScope, name, t, t->type, lineOf(t->offset), nextLocation(curScope));
+          curBucket->decl = curBucket;
           curScope = sc_push(sc_create(name, t));
-          t->scope = curScope;
+          setNodeScope(n, curScope);
           break;
         case VarDeclK:
         case ArrVarDeclK:
           name = t->attr.name;
           curBucket = st_lookup_excluding_parent(curScope, name);
-          if (!strcmp(t->attr.type, "void")) {
+          if (t->decl == Void) {
             if (t->kind.stmt == VarDeclK) {
-              strcpy(errorMsg, " Variable Type cannot be Void");
-              buildingError(t, strcat(name, errorMsg));
+              sprintf(errorMsg, "%.60s Variable Type cannot be Void", name);
+              buildingError(t, errorMsg);
             }
             else{
-              strcpy(errorMsg, " Array Type cannot be Void");
-              buildingError(t, strcat(name, errorMsg));
+              sprintf(errorMsg, "%.60s Array Type cannot be Void", name);
+              buildingError(t, errorMsg);
             }
             break;
           }
@@ -99,14 +81,15 @@ static void insertNode(TreeNode *t)
             buildingError(t, strcat(errorMsg, name));
           }
 
-          if(!strcmp(t->attr.type, "int")){
-            if(t->attr.val == 0)  t->type = Integer;
+          if(t->decl == Integer){
+            if(t->kind.stmt == VarDeclK || arraySize(n) == 0)  t->type = Integer;
             else  t->type = IntegerArray;
           }
-          else if(!strcmp(t->attr.type, "void"))	t->type = Void;
+          else if(t->decl == Void)	t->type = Void;
           
-          st_insert(curScope, name, t, t->type, t->lineno, nextLocation(curScope));
-          t->scope = curScope;
+          curBucket = st_insert(curScope, name, t, t->type, lineOf(t->offset), nextLocation(curScope));
+          curBucket->decl = curBucket;
+          setNodeScope(n, curScope);
           break;
         case CompK:
           if (curScope->scopeCreated == FALSE) {
@@ -114,7 +97,7 @@ static void insertNode(TreeNode *t)
           }
           else {
             curScope = sc_push(sc_create(curScope->name, t));
-            t->scope = curScope;
+            setNodeScope(n, curScope);
             curScope->scopeCreated = TRUE;
           }
           break;
@@ -122,7 +105,7 @@ static void insertNode(TreeNode *t)
         case ArrParamK:
           name = t->attr.name;
           curBucket = st_lookup_excluding_parent(curScope, name);
-          if (!strcmp(t->attr.type, "void")) {
+          if (t->decl == Void) {
             if (!strcmp(curScope->name, "main"))    break;
             buildingError(t, "Parameter Type cannot be Void");
           }
@@ -130,22 +113,25 @@ static void insertNode(TreeNode *t)
             strcpy(errorMsg, "Redefinition of Parameter ");
             buildingError(t, strcat(errorMsg, name));
           }
-          if(!strcmp(t->attr.type, "int")){
+          if(t->decl == Integer){
             if(t->kind.stmt == ParamK)
               t->type = Integer;
           	else
           		t->type = IntegerArray;
           }
-          else if(!strcmp(t->attr.type, "void"))	t->type = Void;
+          else if(t->decl == Void)	t->type = Void;
 
-          st_insert(curScope, name, t, t->type, t->lineno, nextLocation(curScope));
-          t->scope = curScope;
+          curBucket = st_insert(curScope, name, t, t->type, lineOf(t->offset), nextLocation(curScope));
+          curBucket->decl = curBucket;
+          setNodeScope(n, curScope);
           break;
         case IfK:
           break;
         case WhileK:
           break;
         case RetK:
+          curBucket = st_bound(curScope->name);
+          setNodeSymbol(n, curBucket ? curBucket->decl : NULL);
           break;
       	case AssignK:
           break;
@@ -158,27 +144,43 @@ static void insertNode(TreeNode *t)
         case IdK:
       	case ArrIdK:
           name = t->attr.name;
-          curBucket = st_lookup(curScope, name);
+          curBucket = st_bound(name);
           if (curBucket == NULL) {
             strcpy(errorMsg, "Undeclared Variable ");
             buildingError(t, strcat(errorMsg, name));
           }
           if (curBucket)
             t->type = curBucket->type;
-          st_insert(curScope, name, t, t->type, t->lineno, nextLocation(curScope));
-          t->scope = curScope;
+          declBucket = curBucket ? curBucket->decl : NULL;
+          curBucket = st_insert(curScope, name, t, t->type, lineOf(t->offset), nextLocation(curScope));
+          /* an undeclared name stands for its own use, as
+             st_lookup would find it, so that later uses
+             of it resolve to that too */
+          if (declBucket == NULL)
+            declBucket = curBucket;
+          curBucket->decl = declBucket;
+          setNodeScope(n, curScope);
+          setNodeSymbol(n, declBucket);
           break;
         case CallK: {
           name = t->attr.name;
-          curBucket = st_lookup(curScope, name);
+          curBucket = st_bound(name);
           if (curBucket == NULL) {
             strcpy(errorMsg, "Undeclared Function ");
             buildingError(t, strcat(errorMsg, name));
           }
           if (curBucket)
             t->type = curBucket->type;
-          st_insert(curScope, name, t, t->type, t->lineno, nextLocation(curScope));
-          t->scope = curScope;
+          declBucket = curBucket ? curBucket->decl : NULL;
+          curBucket = st_insert(curScope, name, t, t->type, lineOf(t->offset), nextLocation(curScope));
+          if (declBucket == NULL)
+            declBucket = curBucket;
+          curBucket->decl = declBucket;
+          setNodeScope(n, curScope);
+          /* a call to a function defined after it
+             is bound by bindLateCalls */
+          if (declBucket->t->nodekind == StmtK)
+            setNodeSymbol(n, declBucket);
           break;
         }  
         case OpK:
@@ -192,14 +194,16 @@ static void insertNode(TreeNode *t)
     default:
       break;
   }
+  return ALLCHILDREN;
 }
 
-static void afterInsertNode(TreeNode *t)
+static void afterInsertNode(WalkFrame *f)
 {
+  TreeNode *t = node(f->node);
   if (t->nodekind == StmtK && t->kind.stmt == CompK)
     sc_pop();
   else if (t->nodekind == ExpK && (t->kind.exp == AssignK || t->kind.exp == OpK))
-    t->type = t->child[0]->type;
+    t->type = node(t->child[0])->type;
 }
 
 static void initBuildSymtab()
@@ -209,61 +213,87 @@ static void initBuildSymtab()
   curScope = globalScope;
   sc_push(globalScope);
 
-  TreeNode *inpFunc = newStmtNode(FunK);
-  TreeNode *outFunc = newStmtNode(FunK);
-  TreeNode *compStmt;
-  TreeNode *param;
+  NodeId inpFunc = newStmtNode(FunK);
+  NodeId outFunc = newStmtNode(FunK);
+  NodeId compStmt;
+  NodeId param;
+  TreeNode *t;
 
   /* input() */
   compStmt = newStmtNode(CompK);
-  compStmt->lineno = 0;
-  compStmt->child[0] = compStmt->child[1] = NULL;
+  node(compStmt)->offset = -1;
+  node(compStmt)->child[0] = node(compStmt)->child[1] = NONODE;
 
   inpFunc = newStmtNode(FunK);
-  inpFunc->lineno = 0;
-  inpFunc->attr.name = "input";
-  inpFunc->type = Integer;
-  inpFunc->scope = globalScope;
-  inpFunc->child[0] = NULL;
-  inpFunc->child[1] = compStmt;
-  st_insert(globalScope, inpFunc->attr.name, inpFunc, inpFunc->type,
-            inpFunc->lineno, nextLocation(curScope));
-  curScope = sc_push(sc_create(inpFunc->attr.name, inpFunc));
+  t = node(inpFunc);
+  t->offset = -1;
+  t->attr.name = internName("input",5);
+  t->type = Integer;
+  setNodeScope(inpFunc, globalScope);
+  t->child[0] = NONODE;
+  t->child[1] = compStmt;
+  curBucket = st_insert(globalScope, t->attr.name, t, t->type,
+                        lineOf(t->offset), nextLocation(curScope));
+  curBucket->decl = curBucket;
+  curScope = sc_push(sc_create(t->attr.name, t));
 
-  compStmt->scope = curScope;
+  setNodeScope(compStmt, curScope);
   sc_pop();
 
   /* output() */
   compStmt = newStmtNode(CompK);
-  compStmt->lineno = 0;
-  compStmt->child[0] = compStmt->child[1] = NULL;
+  node(compStmt)->offset = -1;
+  node(compStmt)->child[0] = node(compStmt)->child[1] = NONODE;
 
   param = newStmtNode(ParamK);
-  param->attr.name = "arg";
-  param->type = Integer;
+  node(param)->attr.name = internName("arg",3);
+  node(param)->type = Integer;
 
-  outFunc->lineno = 0;
-  outFunc->attr.name = "output";
-  outFunc->type = Void;
-  outFunc->scope = globalScope;
-  outFunc->child[0] = param;
-  outFunc->child[1] = compStmt;
-  st_insert(globalScope, outFunc->attr.name, outFunc, outFunc->type,
-            outFunc->lineno, nextLocation(curScope));
-  curScope = sc_push(sc_create(outFunc->attr.name, outFunc));
+  t = node(outFunc);
+  t->offset = -1;
+  t->attr.name = internName("output",6);
+  t->type = Void;
+  setNodeScope(outFunc, globalScope);
+  t->child[0] = param;
+  t->child[1] = compStmt;
+  curBucket = st_insert(globalScope, t->attr.name, t, t->type,
+                        lineOf(t->offset), nextLocation(curScope));
+  curBucket->decl = curBucket;
+  curScope = sc_push(sc_create(t->attr.name, t));
 
-  compStmt->scope = param->scope = curScope;
+  setNodeScope(compStmt, curScope);
+  setNodeScope(param, curScope);
   sc_pop();
   curScope = globalScope;
 }
 
+/* Procedure bindLateCalls binds each call left
+ * unbound by insertNode to the global declaration
+ * of its name, made after the call, if there is one;
+ * it is called while the global scope is still open
+ */
+static void bindLateCalls(void)
+{ NodeId n, count = nodeCount();
+  for (n = 1; n < count; n++)
+  { TreeNode * t = node(n);
+    if (t->nodekind == ExpK && t->kind.exp == CallK
+        && nodeSymbol(n) == NULL)
+    { Bucket b = st_bound(t->attr.name);
+      if (b != NULL && b->t->nodekind == StmtK)
+        setNodeSymbol(n, b);
+    }
+  }
+}
+
 /* Function buildSymtab constructs the symbol
  * table by preorder traversal of the syntax tree
  */
-void buildSymtab(TreeNode *syntaxTree)
+void buildSymtab(NodeId syntaxTree)
 {
+  static const WalkProcs procs = {insertNode,NULL,afterInsertNode};
   initBuildSymtab();
-  traverse(syntaxTree,insertNode,afterInsertNode);
+  walkTree(syntaxTree,&procs);
+  bindLateCalls();
   sc_pop();
   if (TraceAnalyze)
   {
@@ -272,15 +302,19 @@ void buildSymtab(TreeNode *syntaxTree)
 }
 
 static void typeError(TreeNode *t, char *message)
-{ fprintf(listing,"Error: Type error at line %d: %s\n",t->lineno,message);
+{ fprintf(listing,"Error: Type error at line %d: %s\n",lineOf(t->offset),message);
   Error = TRUE;
 }
 
 /* Procedure checkNode performs
- * type checking at a single tree node
+ * type checking at a single tree node;
+ * the names in the tree were resolved
+ * by buildSymtab (see nodeSymbol)
  */
-static void checkNode(TreeNode *t)
+static void checkNode(WalkFrame *f)
 {
+  NodeId n = f->node;
+  TreeNode *t = node(n);
   switch (t->nodekind) {
     case StmtK:
       switch (t->kind.stmt) {
@@ -288,24 +322,25 @@ static void checkNode(TreeNode *t)
           break;
         case IfK:
         case WhileK:
-          if (t->child[0] == NULL)
+          if (t->child[0] == NONODE)
             typeError(t, "expected expression");
-          else if (t->child[0]->type == Void)
+          else if (node(t->child[0])->type == Void)
             typeError(t, "statement requires expression of scalar type ('void' invalid)");
           break;
         case RetK:{
-          Bucket funcBucket = st_lookup(t->scope, t->scope->name);
+          Bucket funcBucket = nodeSymbol(n);
           ExpType funcType = funcBucket->type;
-          TreeNode *expr = t->child[0];
+          NodeId e = t->child[0];
+          TreeNode *expr = node(e);
           if (expr->type == Void && expr->kind.exp == ConstK)
             expr->type = Integer;
 
-          if (funcType == Void && expr != NULL && expr->type != Void)
+          if (funcType == Void && e != NONODE && expr->type != Void)
             typeError(t, "invalid return type");
-          else if (funcType == Integer && (expr == NULL || expr->type != Integer)) {
-            if (expr == NULL)
+          else if (funcType == Integer && (e == NONODE || expr->type != Integer)) {
+            if (e == NONODE)
               typeError(t, "invalid return type");
-            else if (expr->type == IntegerArray && expr->child[0] != NULL)
+            else if (expr->type == IntegerArray && expr->child[0] != NONODE)
               break;
             else
               typeError(t, "invalid return type");
@@ -313,8 +348,8 @@ static void checkNode(TreeNode *t)
           break;
         }
         case AssignK:{
-          TreeNode *leftOp = t->child[0];
-          TreeNode *rightOp = t->child[1];
+          TreeNode *leftOp = node(t->child[0]);
+          TreeNode *rightOp = node(t->child[1]);
           
           if (leftOp->type == Void && leftOp->kind.exp == ConstK)
             leftOp->type = Integer;
@@ -323,9 +358,9 @@ static void checkNode(TreeNode *t)
           
           if (leftOp->type == Void || rightOp->type == Void)
             typeError(t, "expression is not assignable");
-          else if (leftOp->type == IntegerArray && leftOp->child[0] == NULL)
+          else if (leftOp->type == IntegerArray && leftOp->child[0] == NONODE)
             typeError(t, "type inconsistance");
-          else if (rightOp->type == IntegerArray && rightOp->child[0] == NULL)
+          else if (rightOp->type == IntegerArray && rightOp->child[0] == NONODE)
             typeError(t, "type inconsistance");
           break;
         }
@@ -336,10 +371,11 @@ static void checkNode(TreeNode *t)
     case ExpK:
       switch (t->kind.exp) {
         case IdK:
-          curBucket = st_lookup(t->scope, t->attr.name);
-          t->type = curBucket->type;
-          if (t->child[0] != NULL) {
-            if (t->child[0]->type != Integer) {
+          curBucket = nodeSymbol(n);
+          if (curBucket)
+            t->type = curBucket->type;
+          if (t->child[0] != NONODE) {
+            if (node(t->child[0])->type != Integer) {
               strcpy(errorMsg, "array subscript is not an integer");
               typeError(t, strcat(errorMsg, t->attr.name));
               break;
@@ -347,7 +383,7 @@ static void checkNode(TreeNode *t)
           }
           break;
         case CallK:
-          curBucket = st_lookup(t->scope->parent, t->attr.name);
+          curBucket = nodeSymbol(n);
           if (curBucket == NULL) {
             strcpy(errorMsg, "implicit declaration of function ");
             typeError(t, strcat(errorMsg, t->attr.name));
@@ -356,37 +392,41 @@ static void checkNode(TreeNode *t)
           t->type = curBucket->type;
 
           TreeNode *func = curBucket->t;
-          TreeNode *param = func->child[0];
-          TreeNode *arg = t->child[0];
+          NodeId param = func->child[0];
+          NodeId arg = t->child[0];
           while (arg) {
+            TreeNode *p = node(param);
+            TreeNode *a = node(arg);
             if (!param) {
               typeError(t, "invalid function call");
               break;
             }
-            else if (param->type != arg->type) {
-              if((param->type == Integer || param->type == IntegerArray) 
-                      && (arg->type == Integer || arg->type == IntegerArray || arg->kind.exp == ConstK))	break;
+            else if (p->type != a->type) {
+              if((p->type == Integer || p->type == IntegerArray) 
+                      && (a->type == Integer || a->type == IntegerArray || a->kind.exp == ConstK))	break;
               typeError(t, "invalid function call");
               break;
             }
             else {
-              arg = arg->sibling;
-              param = param->sibling;
+              arg = a->sibling;
+              param = p->sibling;
             }
           }
-          if (arg == NULL && param != NULL)
+          if (arg == NONODE && param != NONODE)
             typeError(t, "invalid function call");
           break;
         case OpK:{
-          ExpType leftType = t->child[0]->type;
-          ExpType rightType = t->child[1]->type;
-          if (leftType == IntegerArray && t->child[0]->child[0] != NULL)
+          TreeNode *left = node(t->child[0]);
+          TreeNode *right = node(t->child[1]);
+          ExpType leftType = left->type;
+          ExpType rightType = right->type;
+          if (leftType == IntegerArray && left->child[0] != NONODE)
             leftType = Integer;
-          else if (leftType == Void && t->child[0]->kind.exp == ConstK)
+          else if (leftType == Void && left->kind.exp == ConstK)
             leftType = Integer;
-          if (rightType == IntegerArray && t->child[1]->child[0] != NULL)
+          if (rightType == IntegerArray && right->child[0] != NONODE)
             rightType = Integer;
-          else if (rightType == Void && t->child[1]->kind.exp == ConstK)
+          else if (rightType == Void && right->kind.exp == ConstK)
             rightType = Integer;
           
           if (leftType == Void || rightType == Void){
@@ -411,9 +451,10 @@ static void checkNode(TreeNode *t)
 /* Procedure typeCheck performs type checking
  * by a postorder syntax tree traversal
  */
-void typeCheck(TreeNode *syntaxTree)
+void typeCheck(NodeId syntaxTree)
 {
+  static const WalkProcs procs = {NULL,NULL,checkNode};
   sc_push(globalScope);
-  traverse(syntaxTree,nullProc,checkNode);
+  walkTree(syntaxTree,&procs);
   sc_pop();
 }
@@ -11,11 +11,11 @@
 /* Function buildSymtab constructs the symbol 
  * table by preorder traversal of the syntax tree
  */
-void buildSymtab(TreeNode *);
+void buildSymtab(NodeId);
 
 /* Procedure typeCheck performs type checking 
  * by a postorder syntax tree traversal
  */
-void typeCheck(TreeNode *);
+void typeCheck(NodeId);
 
 #endif
@@ -0,0 +1,76 @@
+/****************************************************/
+/* File: arena.c                                    */
+/* Bump-pointer arena allocator for the C-Minus     */
+/* compiler                                         */
+/****************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "arena.h"
+
+/* BLOCKSIZE = bytes in an ordinary block, header
+   included; a request too large for one gets a
+   block of its own. ALIGN = alignment of every
+   allocation */
+#define BLOCKSIZE (64L * 1024)
+#define ALIGN 16
+
+/* the header in front of each block; the memory
+   handed out follows it */
+struct arenaBlock
+   { struct arenaBlock * next;
+     long size; /* bytes of the block, header included */
+   };
+
+#define HEADER ((sizeof(struct arenaBlock) + ALIGN-1) & ~(size_t) (ALIGN-1))
+
+/* Function arenaAlloc returns n bytes from a,
+ * aligned for any type
+ */
+void * arenaAlloc( Arena * a, size_t n )
+{ char * p;
+  n = (n + ALIGN-1) & ~(size_t) (ALIGN-1);
+  if ((a->next == NULL) || ((size_t) (a->limit - a->next) < n))
+  { long size = (HEADER + n > BLOCKSIZE) ? (long) (HEADER + n) : BLOCKSIZE;
+    struct arenaBlock * b = (struct arenaBlock *) malloc(size);
+    if (b == NULL) return NULL;
+    b->size = size;
+    a->reserved += size;
+    if ((size > BLOCKSIZE) && (a->blocks != NULL))
+    { /* an outsized block: keep bumping in the current one */
+      b->next = a->blocks->next;
+      a->blocks->next = b;
+      a->used += n;
+      return (char *) b + HEADER;
+    }
+    b->next = a->blocks;
+    a->blocks = b;
+    a->next = (char *) b + HEADER;
+    a->limit = (char *) b + size;
+  }
+  p = a->next;
+  a->next += n;
+  a->used += n;
+  return p;
+}
+
+/* Function arenaString returns a copy of s in a */
+char * arenaString( Arena * a, const char * s )
+{ size_t n = strlen(s)+1;
+  char * t = (char *) arenaAlloc(a,n);
+  if (t != NULL) memcpy(t,s,n);
+  return t;
+}
+
+/* Procedure arenaRelease frees every block of a */
+void arenaRelease( Arena * a )
+{ struct arenaBlock * b = a->blocks;
+  while (b != NULL)
+  { struct arenaBlock * next = b->next;
+    free(b);
+    b = next;
+  }
+  a->blocks = NULL;
+  a->next = a->limit = NULL;
+  a->used = a->reserved = 0;
+}
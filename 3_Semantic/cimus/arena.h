@@ -0,0 +1,43 @@
+/****************************************************/
+/* File: arena.h                                    */
+/* Bump-pointer arena allocator for the C-Minus     */
+/* compiler                                         */
+/****************************************************/
+
+#ifndef _ARENA_H_
+#define _ARENA_H_
+
+#include <stddef.h>
+
+/* An Arena hands out memory from large blocks by
+ * moving a pointer along the current block, with no
+ * per-allocation header; nothing in it is freed on
+ * its own, and arenaRelease frees everything at once.
+ * An Arena whose fields are all zero is empty and
+ * ready for use
+ */
+typedef struct
+   { struct arenaBlock * blocks; /* newest block first */
+     char * next;    /* first free byte of the newest block */
+     char * limit;   /* first byte after the newest block */
+     long used;      /* bytes handed out */
+     long reserved;  /* bytes of the blocks, headers included */
+   } Arena;
+
+/* Function arenaAlloc returns n bytes from a,
+ * aligned for any type, or NULL if it runs out of
+ * memory
+ */
+void * arenaAlloc( Arena * a, size_t n );
+
+/* Function arenaString returns a copy of s in a, or
+ * NULL if it runs out of memory
+ */
+char * arenaString( Arena * a, const char * s );
+
+/* Procedure arenaRelease frees every block of a,
+ * leaving it empty
+ */
+void arenaRelease( Arena * a );
+
+#endif
@@ -0,0 +1,577 @@
+/****************************************************/
+/* File: astcache.c                                 */
+/* Syntax tree cache files for the C-Minus compiler */
+/****************************************************/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "globals.h"
+#include "util.h"
+#include "scan.h"
+#include "parse.h"
+#include "pipeparse.h"
+#include "intern.h"
+#include "source.h"
+#include "lineidx.h"
+#include "walk.h"
+#include "astcache.h"
+
+/* CMAST_VERSION changes whenever what the parser
+   builds or the layout of the file does, so that
+   older files are never read as current ones */
+#define CMAST_MAGIC "CMAST\r\n\032"
+#define CMAST_VERSION 3
+
+/* A cache file is a CacheHeader followed by the
+ * array sizes (nSizes ArraySizes), the top-level
+ * declarations (nDecls TopDecls), the names (nNames
+ * strings, each ending in '\0', nameBytes in all),
+ * the source (srcLen bytes) and, at the next
+ * multiple of 8 bytes, the node array, node 0
+ * included; a node with a name holds the name's
+ * index in attr.val. garbage counts the nodes no
+ * longer in the tree. check is a hash of everything
+ * after the header
+ */
+typedef struct
+   { char magic[8];
+     unsigned int version;
+     unsigned int nodeSize;   /* sizeof(TreeNode) */
+     unsigned long long srcHash;
+     long long srcLen;
+     unsigned long long check;
+     NodeId root;
+     NodeId nodes;
+     NodeId garbage;
+     unsigned int nSizes;
+     unsigned int nDecls;
+     unsigned int nNames;
+     long long nameBytes;
+     long long stmtNodes;
+     long long expNodes;
+   } CacheHeader;
+
+#define ALIGN8(n) (((n) + 7) & ~(size_t) 7)
+
+/* nodeOffset is where the node array of a file
+   with header h starts */
+static size_t nodeOffset( const CacheHeader * h )
+{ return ALIGN8(sizeof(CacheHeader) + (size_t) h->nSizes*sizeof(ArraySize)
+                + (size_t) h->nDecls*sizeof(TopDecl)
+                + (size_t) h->nameBytes + (size_t) h->srcLen);
+}
+
+/* hashBytes continues the hash h over the n bytes
+   at p, a word at a time */
+static unsigned long long hashBytes( const void * p, size_t n, unsigned long long h )
+{ const unsigned char * s = (const unsigned char *) p;
+  unsigned long long w;
+  h ^= n;
+  for (;n >= 8;n -= 8, s += 8)
+  { memcpy(&w,s,8);
+    h = (h ^ w) * 0x100000001b3ULL;
+    h ^= h >> 29;
+  }
+  for (;n > 0;n--, s++)
+    h = (h ^ *s) * 0x100000001b3ULL;
+  return h;
+}
+
+#define HASHSEED 0xcbf29ce484222325ULL
+
+/* hasName is TRUE for the kinds of node whose
+   attribute is a name */
+static int hasName( const TreeNode * t )
+{ if (t->nodekind == StmtK)
+    switch (t->kind.stmt) {
+      case VarDeclK: case ArrVarDeclK: case FunK:
+      case ParamK: case ArrParamK: case AssignK: case ReadK:
+        return TRUE;
+      default:
+        return FALSE;
+    }
+  switch (t->kind.exp) {
+    case IdK: case ArrIdK: case CallK:
+      return TRUE;
+    default:
+      return FALSE;
+  }
+}
+
+/* the names of a tree being written, each with the
+   index it is written under; the slots are an open
+   addressing table on the names' own hashes */
+typedef struct
+   { char ** slot;   /* name in each slot, or NULL */
+     unsigned int * index;
+     unsigned int size;     /* slots, a power of 2 */
+     char ** names;  /* the names by index */
+     unsigned int nNames;
+     size_t bytes;
+   } NameTable;
+
+/* nameIndex returns the index of name in nt, adding
+   it if it is new; -1 if it runs out of memory */
+static long nameIndex( NameTable * nt, char * name )
+{ unsigned int i;
+  if (2*(nt->nNames+1) > nt->size)
+  { unsigned int size = nt->size ? 2*nt->size : 256;
+    char ** slot = (char **) calloc(size,sizeof(char *));
+    unsigned int * index = (unsigned int *) malloc(size*sizeof(unsigned int));
+    char ** names = (char **) realloc(nt->names,(size/2)*sizeof(char *));
+    if ((slot == NULL) || (index == NULL) || (names == NULL))
+    { free(slot);
+      free(index);
+      if (names != NULL) nt->names = names;
+      return -1;
+    }
+    nt->names = names;
+    for (i=0;i<nt->nNames;i++)
+    { unsigned int j = nameHash(names[i]) & (size-1);
+      while (slot[j] != NULL) j = (j+1) & (size-1);
+      slot[j] = names[i];
+      index[j] = i;
+    }
+    free(nt->slot);
+    free(nt->index);
+    nt->slot = slot;
+    nt->index = index;
+    nt->size = size;
+  }
+  i = nameHash(name) & (nt->size-1);
+  while (nt->slot[i] != NULL)
+  { if (nt->slot[i] == name) return nt->index[i];
+    i = (i+1) & (nt->size-1);
+  }
+  nt->slot[i] = name;
+  nt->index[i] = nt->nNames;
+  nt->names[nt->nNames] = name;
+  nt->bytes += strlen(name)+1;
+  return nt->nNames++;
+}
+
+/* garbage counts the nodes of the compilation in
+   progress no longer in its tree */
+static NodeId garbage;
+
+/* writeAst writes the tree root, whose source hashes
+   to srcHash, to fp; returns FALSE if it fails */
+static int writeAst( FILE * fp, NodeId root, unsigned long long srcHash )
+{ static const char zeros[8];
+  NameTable nt;
+  ArraySize * sizes = NULL;
+  unsigned int nSizes = 0, maxSizes = 0;
+  TreeNode * buf = NULL;
+  TopDecl * decls;
+  int nDecls;
+  CacheHeader h;
+  NodeId n = nodeCount(), i;
+  unsigned int j;
+  size_t pad;
+  int ok = FALSE;
+  memset(&nt,0,sizeof(nt));
+  memset(&h,0,sizeof(h));
+  for (i=1;i<n;i++)
+  { TreeNode * t = node(i);
+    if (t->nodekind == StmtK) h.stmtNodes++;
+    else h.expNodes++;
+    if (hasName(t) && (nameIndex(&nt,t->attr.name) < 0)) goto done;
+    if ((t->nodekind == StmtK) && (t->kind.stmt == ArrVarDeclK))
+    { if (nSizes == maxSizes)
+      { unsigned int max = maxSizes ? 2*maxSizes : 64;
+        ArraySize * p = (ArraySize *) realloc(sizes,max*sizeof(ArraySize));
+        if (p == NULL) goto done;
+        sizes = p;
+        maxSizes = max;
+      }
+      sizes[nSizes].node = i;
+      sizes[nSizes].size = arraySize(i);
+      nSizes++;
+    }
+  }
+  buf = (TreeNode *) malloc(NODECHUNK*sizeof(TreeNode));
+  if (buf == NULL) goto done;
+  decls = topDecls(&nDecls);
+  memcpy(h.magic,CMAST_MAGIC,8);
+  h.version = CMAST_VERSION;
+  h.nodeSize = sizeof(TreeNode);
+  h.srcHash = srcHash;
+  h.srcLen = srcLen;
+  h.root = root;
+  h.nodes = n;
+  h.garbage = garbage;
+  h.nSizes = nSizes;
+  h.nDecls = nDecls;
+  h.nNames = nt.nNames;
+  h.nameBytes = nt.bytes;
+  /* the header goes first with check still 0, and
+     again at the end once check is known */
+  if (fwrite(&h,sizeof(h),1,fp) != 1) goto done;
+  h.check = hashBytes(sizes,nSizes*sizeof(ArraySize),HASHSEED);
+  if ((nSizes > 0) && (fwrite(sizes,sizeof(ArraySize),nSizes,fp) != nSizes)) goto done;
+  h.check = hashBytes(decls,nDecls*sizeof(TopDecl),h.check);
+  if ((nDecls > 0) && (fwrite(decls,sizeof(TopDecl),nDecls,fp) != (size_t) nDecls)) goto done;
+  for (j=0;j<nt.nNames;j++)
+  { size_t len = strlen(nt.names[j])+1;
+    h.check = hashBytes(nt.names[j],len,h.check);
+    if (fwrite(nt.names[j],1,len,fp) != len) goto done;
+  }
+  h.check = hashBytes(srcText,srcLen,h.check);
+  if (fwrite(srcText,1,srcLen,fp) != (size_t) srcLen) goto done;
+  pad = nodeOffset(&h) - (sizeof(h) + nSizes*sizeof(ArraySize) + nDecls*sizeof(TopDecl)
+                          + nt.bytes + srcLen);
+  if (fwrite(zeros,1,pad,fp) != pad) goto done;
+  for (i=0;i<n;i+=NODECHUNK)
+  { NodeId k, m = (n-i < NODECHUNK) ? n-i : NODECHUNK;
+    memcpy(buf,node(i),m*sizeof(TreeNode));
+    for (k=0;k<m;k++)
+      if ((i+k > 0) && hasName(&buf[k]))
+      { memset(&buf[k].attr,0,sizeof(buf[k].attr));
+        buf[k].attr.val = (int) nameIndex(&nt,node(i+k)->attr.name);
+      }
+    h.check = hashBytes(buf,m*sizeof(TreeNode),h.check);
+    if (fwrite(buf,sizeof(TreeNode),m,fp) != m) goto done;
+  }
+  if ((fseek(fp,0,SEEK_SET) == 0) && (fwrite(&h,sizeof(h),1,fp) == 1))
+    ok = TRUE;
+done:
+  free(nt.slot);
+  free(nt.index);
+  free(nt.names);
+  free(sizes);
+  free(buf);
+  return ok;
+}
+
+/* saveAst writes the tree root to astfile by way of
+   a temporary file, so that no reader ever sees a
+   file half written */
+static void saveAst( const char * astfile, NodeId root, unsigned long long srcHash )
+{ char * tmp = (char *) malloc(strlen(astfile)+5);
+  FILE * fp;
+  int ok;
+  if (tmp == NULL) return;
+  strcpy(tmp,astfile);
+  strcat(tmp,".tmp");
+  fp = fopen(tmp,"wb");
+  if (fp == NULL)
+  { fprintf(listing,"Unable to write %s\n",astfile);
+    free(tmp);
+    return;
+  }
+  ok = writeAst(fp,root,srcHash);
+  if (fclose(fp) != 0) ok = FALSE;
+  if (!ok || (rename(tmp,astfile) != 0))
+  { fprintf(listing,"Unable to write %s\n",astfile);
+    remove(tmp);
+  }
+  free(tmp);
+}
+
+/* a cache file mapped in: the node array is mapped
+   over zeroed memory that rounds it up to whole
+   chunks, as adoptNodes wants */
+typedef struct
+   { CacheHeader h;
+     char * base;
+     size_t len;
+     ArraySize * sizes;
+     TopDecl * decls;
+     char * names;
+     char * text;   /* the source it was written for */
+     TreeNode * nodes;
+   } CacheMap;
+
+/* mapCache maps astfile into m, returning FALSE if
+   it is missing, of another version or damaged */
+static int mapCache( const char * astfile, CacheMap * m )
+{ CacheHeader * h = &m->h;
+  struct stat st;
+  size_t page = (size_t) sysconf(_SC_PAGESIZE);
+  NodeId i, chunks;
+  unsigned int j;
+  unsigned long long check;
+  char * p, * end;
+  int fd = open(astfile,O_RDONLY);
+  if (fd < 0) return FALSE;
+  if ((fstat(fd,&st) < 0) || (st.st_size < (off_t) sizeof(CacheHeader)) ||
+      (pread(fd,h,sizeof(CacheHeader),0) != sizeof(CacheHeader)) ||
+      (memcmp(h->magic,CMAST_MAGIC,8) != 0) || (h->version != CMAST_VERSION) ||
+      (h->nodeSize != sizeof(TreeNode)) || (h->nodes == 0) ||
+      (h->root >= h->nodes) || (h->nameBytes < 0) || (h->srcLen < 0) ||
+      ((off_t) (nodeOffset(h)+(size_t) h->nodes*sizeof(TreeNode)) != st.st_size))
+  { close(fd);
+    return FALSE;
+  }
+  chunks = (h->nodes + NODECHUNK-1) >> NODESHIFT;
+  m->len = (nodeOffset(h) + (size_t) chunks*NODECHUNK*sizeof(TreeNode) + page-1) / page * page;
+  m->base = (char *) mmap(NULL,m->len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if (m->base == MAP_FAILED)
+  { close(fd);
+    return FALSE;
+  }
+  if (mmap(m->base,(size_t) st.st_size,PROT_READ|PROT_WRITE,
+           MAP_PRIVATE|MAP_FIXED,fd,0) == MAP_FAILED)
+  { close(fd);
+    munmap(m->base,m->len);
+    return FALSE;
+  }
+  close(fd);
+  m->sizes = (ArraySize *) (m->base + sizeof(CacheHeader));
+  m->decls = (TopDecl *) (m->sizes + h->nSizes);
+  m->names = (char *) (m->decls + h->nDecls);
+  m->text = m->names + h->nameBytes;
+  m->nodes = (TreeNode *) (m->base + nodeOffset(h));
+  /* check the body against the hash it was written
+     with, in the same pieces */
+  check = hashBytes(m->sizes,h->nSizes*sizeof(ArraySize),HASHSEED);
+  check = hashBytes(m->decls,h->nDecls*sizeof(TopDecl),check);
+  for (j=0, p=m->names, end=m->text;(j<h->nNames) && (p<end);j++)
+  { size_t n = strnlen(p,end-p)+1;
+    check = hashBytes(p,n,check);
+    p += n;
+  }
+  check = hashBytes(m->text,h->srcLen,check);
+  for (i=0;i<h->nodes;i+=NODECHUNK)
+    check = hashBytes(m->nodes+i,
+                      ((h->nodes-i < NODECHUNK) ? h->nodes-i : NODECHUNK)*sizeof(TreeNode),check);
+  if ((j != h->nNames) || (p != end) || (check != h->check))
+  { munmap(m->base,m->len);
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* adoptCache makes the tree of m that of the
+   compilation in progress and returns its root, or
+   NONODE, m being unmapped, if it does not hold
+   together */
+static NodeId adoptCache( CacheMap * m )
+{ CacheHeader * h = &m->h;
+  char ** names;
+  char * p = m->names;
+  NodeId i;
+  unsigned int j;
+  names = (char **) malloc((h->nNames ? h->nNames : 1)*sizeof(char *));
+  if (names == NULL) goto bad;
+  for (j=0;j<h->nNames;j++)
+  { size_t n = strlen(p);
+    names[j] = internName(p,(int) n);
+    p += n+1;
+  }
+  for (i=1;i<h->nodes;i++)
+    if (hasName(&m->nodes[i]))
+    { if ((unsigned int) m->nodes[i].attr.val >= h->nNames) goto bad;
+      m->nodes[i].attr.name = names[m->nodes[i].attr.val];
+    }
+  for (j=0;j<h->nDecls;j++)
+    if (m->decls[j].node >= h->nodes) goto bad;
+  free(names);
+  for (j=0;j<h->nSizes;j++)
+    setArraySize(m->sizes[j].node,m->sizes[j].size);
+  for (j=0;j<h->nDecls;j++)
+    addTopDecl(m->decls[j].node,m->decls[j].start);
+  adoptNodes(m->nodes,h->nodes,h->stmtNodes,h->expNodes,m->base,m->len);
+  garbage = h->garbage;
+  return h->root;
+bad:
+  free(names);
+  munmap(m->base,m->len);
+  return NONODE;
+}
+
+/* commentIn is TRUE if a comment could start or end
+   in the n bytes at p, or across either end of them */
+static int commentIn( const char * p, long n, const char * text, long len )
+{ long i = (p > text) ? -1 : 0;
+  long last = (p+n < text+len) ? n : n-1;
+  for (;i<last;i++)
+    if (((p[i] == '/') && (p[i+1] == '*')) || ((p[i] == '*') && (p[i+1] == '/')))
+      return TRUE;
+  return FALSE;
+}
+
+/* nextToken fills tok from getToken */
+static void nextToken( TokenRec * tok )
+{ tok->kind = getToken();
+  tok->offset = tokenOffset;
+  tok->length = tokenLength;
+  tok->name = tokenName;
+}
+
+/* parseSlice parses the source from start to end on
+   its own, setting *list to the declarations in it,
+   NONODE if none. Returns FALSE if it does not parse;
+   syntax errors go to a scratch file instead of the
+   listing, as the whole source is parsed after */
+static int parseSlice( long start, long end, NodeId * list )
+{ FILE * saved = listing;
+  ParseState ps;
+  ParseStatus status = ParseMore;
+  TokenRec tok;
+  *list = NONODE;
+  if (!scanRange(start,end)) return FALSE;
+  nextToken(&tok);
+  if (tok.kind == ENDFILE) return TRUE;
+  listing = tmpfile();
+  if (listing == NULL)
+  { listing = saved;
+    return FALSE;
+  }
+  ps = parseStart();
+  if (ps != NULL)
+  { while (status == ParseMore)
+    { status = parsePush(ps,&tok,1);
+      if (status == ParseMore) nextToken(&tok);
+    }
+    *list = parseFinish(ps);
+  }
+  fclose(listing);
+  listing = saved;
+  if ((ps == NULL) || (status != ParseDone) || Error)
+  { Error = FALSE;
+    return FALSE;
+  }
+  return TRUE;
+}
+
+/* shift is what shiftNode adds to the offsets of the
+   nodes it visits, and removed counts the nodes
+   countNode visits */
+static int shift;
+static NodeId removed;
+
+static int shiftNode( WalkFrame * f )
+{ TreeNode * t = node(f->node);
+  if (t->offset >= 0) t->offset += shift;
+  return ALLCHILDREN;
+}
+
+static int countNode( WalkFrame * f )
+{ (void) f;
+  removed++;
+  return ALLCHILDREN;
+}
+
+/* updateCache brings the tree of m, written for an
+   earlier version of the source, up to date with it,
+   returning NONODE if the whole source has to be
+   parsed instead; m is adopted or unmapped */
+static NodeId updateCache( CacheMap * m, CacheStats * stats )
+{ static const WalkProcs shifter = {shiftNode,NULL,NULL};
+  static const WalkProcs counter = {countNode,NULL,NULL};
+  TopDecl * old = m->decls, * decls, * table;
+  long oldLen = m->h.srcLen;
+  long common = (oldLen < srcLen) ? oldLen : srcLen;
+  long pre = 0, suf = 0, start, end;
+  int n = m->h.nDecls, total, a, b, k, i;
+  NodeId root, fresh, prev, next;
+  /* the changed text lies between the longest common
+     prefix and suffix of the two versions */
+  while ((pre < common) && (m->text[pre] == srcText[pre])) pre++;
+  while ((suf < common-pre) &&
+         (m->text[oldLen-1-suf] == srcText[srcLen-1-suf])) suf++;
+  if ((n == 0) || commentIn(m->text+pre,oldLen-suf-pre,m->text,oldLen) ||
+      commentIn(srcText+pre,srcLen-suf-pre,srcText,srcLen))
+  { munmap(m->base,m->len);
+    return NONODE;
+  }
+  /* declaration a is the last to start at or before
+     the change, and b the first to start in the
+     common suffix; a up to b are parsed again, from
+     the start of a (or of the source, if the change
+     comes before any declaration) to that of b */
+  for (a=0;(a+1 < n) && (old[a+1].start <= pre);a++) ;
+  start = (old[a].start <= pre) ? old[a].start : 0;
+  for (b=a;(b < n) && (old[b].start < oldLen-suf);b++) ;
+  shift = (int) (srcLen - oldLen);
+  end = (b < n) ? old[b].start + shift : srcLen;
+  if ((start == 0) && (end == srcLen))
+  { /* nothing would be kept */
+    munmap(m->base,m->len);
+    return NONODE;
+  }
+  root = adoptCache(m);
+  if ((root == NONODE) || !parseSlice(start,end,&fresh)) return NONODE;
+  /* the slice's declarations went on the end of the
+     table: put them in place of a up to b */
+  decls = topDecls(&total);
+  k = total - n;
+  table = (TopDecl *) malloc((n-(b-a)+k)*sizeof(TopDecl));
+  if (table == NULL) return NONODE;
+  memcpy(table,decls,a*sizeof(TopDecl));
+  memcpy(table+a,decls+n,k*sizeof(TopDecl));
+  for (i=b;i<n;i++)
+  { table[a+k+i-b].node = decls[i].node;
+    table[a+k+i-b].start = decls[i].start + shift;
+  }
+  prev = (a > 0) ? decls[a-1].node : NONODE;
+  next = (b < n) ? decls[b].node : NONODE;
+  if (b > a)
+  { removed = 0;
+    node(decls[b-1].node)->sibling = NONODE;
+    walkTree(decls[a].node,&counter);
+    garbage += removed;
+  }
+  if ((shift != 0) && (next != NONODE)) walkTree(next,&shifter);
+  if (k > 0) node(table[a+k-1].node)->sibling = next;
+  else fresh = next;
+  if (prev != NONODE) node(prev)->sibling = fresh;
+  else root = fresh;
+  replaceTopDecls(table,n-(b-a)+k);
+  stats->reparsed = k;
+  stats->bytes = end - start;
+  stats->dirty = (k > 0) ? table[a].node : NONODE;
+  return root;
+}
+
+/* Function cachedParse returns the syntax tree of
+ * the source, from the cache file astfile if it
+ * holds this source's tree or an earlier one's
+ */
+NodeId cachedParse( const char * astfile, CacheStats * stats )
+{ unsigned long long srcHash;
+  CacheStats s;
+  CacheMap m;
+  NodeId t = NONODE;
+  memset(&s,0,sizeof(s));
+  garbage = 0;
+  if (TraceScan || ((srcText == NULL) && (!mapSource(source) || !buildLineIndex())))
+  { t = PipeParse ? pipeParse(NULL) : parse();
+    s.bytes = srcLen;
+    if (stats != NULL) *stats = s;
+    return t;
+  }
+  srcHash = hashBytes(srcText,srcLen,HASHSEED);
+  if ((nodeCount() == 0) && mapCache(astfile,&m))
+  { if ((m.h.srcHash == srcHash) && (m.h.srcLen == srcLen))
+    { t = adoptCache(&m);
+      s.result = CacheHit;
+    }
+    else if (IncrementalParse && (2*m.h.garbage <= m.h.nodes))
+    { t = updateCache(&m,&s);
+      s.result = CacheUpdate;
+    }
+    else munmap(m.base,m.len);
+  }
+  if (t == NONODE)
+  { /* whatever was adopted before giving up is left
+       over, and its declarations are forgotten */
+    garbage = nodeCount();
+    replaceTopDecls(NULL,0);
+    scanRange(0,-1);
+    t = PipeParse ? pipeParse(NULL) : parse();
+    s.result = CacheMiss;
+    s.bytes = srcLen;
+    s.dirty = t;
+    topDecls(&s.reparsed);
+  }
+  endScan();
+  if ((s.result != CacheHit) && !Error) saveAst(astfile,t,srcHash);
+  topDecls(&s.decls);
+  if (stats != NULL) *stats = s;
+  return t;
+}
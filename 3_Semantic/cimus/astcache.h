@@ -0,0 +1,63 @@
+/****************************************************/
+/* File: astcache.h                                 */
+/* Syntax tree cache files for the C-Minus compiler */
+/****************************************************/
+
+#ifndef _ASTCACHE_H_
+#define _ASTCACHE_H_
+
+/* A cache file (.cmast) holds the syntax tree of a
+ * source program together with the source itself, a
+ * hash of it and the table of its top-level
+ * declarations (see TopDecl in util.h). Nodes are
+ * stored as the node array itself, names as indexes
+ * into a table of the names, so the file holds no
+ * pointers: it is mapped back in place and only the
+ * names are fixed up. A file written by another
+ * version of the compiler, or damaged, is never
+ * used; the source is parsed again instead.
+ *
+ * A file for an earlier version of the source is
+ * brought up to date when IncrementalParse is set:
+ * the top-level declarations whose text changed are
+ * parsed again, on their own, and the declarations
+ * they make take their place in the earlier tree.
+ * The rest of the tree is kept as it was, with its
+ * offsets moved along by the change in length. The
+ * whole source is parsed again if a comment starts
+ * or ends in the changed text, since that changes
+ * how the text after it scans, if the changed
+ * declarations are the whole program or do not
+ * parse on their own, or if
+ * the nodes left over from earlier changes would
+ * outnumber the live ones
+ */
+
+typedef enum {CacheMiss,CacheHit,CacheUpdate} CacheResult;
+
+/* CacheStats tell how cachedParse got the tree.
+ * After a CacheUpdate the declarations parsed again
+ * are the reparsed ones of the program's list from
+ * dirty on; later passes need only look at those
+ */
+typedef struct
+   { CacheResult result;
+     int decls;      /* top-level declarations */
+     int reparsed;   /* of them parsed again */
+     long bytes;     /* bytes of source parsed */
+     NodeId dirty;   /* the first declaration parsed again */
+   } CacheStats;
+
+/* Function cachedParse returns the syntax tree of
+ * the source, taken from the cache file astfile when
+ * that holds the tree of this very source, updated
+ * from it as above, or parsed; the tree is written
+ * to astfile for next time unless it came from there
+ * unchanged or the parse found errors. stats, if not
+ * NULL, tells which. Tracing the scanner bypasses
+ * the cache. It must be the first thing to add
+ * nodes to the compilation in progress
+ */
+NodeId cachedParse( const char * astfile, CacheStats * stats );
+
+#endif
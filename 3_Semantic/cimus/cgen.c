@@ -8,7 +8,10 @@
 /****************************************************/
 
 #include "globals.h"
+#include "util.h"
+#include "walk.h"
 #include "symtab.h"
+#include "lineidx.h"
 #include "code.h"
 #include "cgen.h"
 
@@ -18,86 +21,139 @@
 */
 static int tmpOffset = 0;
 
-/* prototype for internal recursive code generator */
-static void cGen (TreeNode * tree);
+/* varLoc returns the memory location of the
+   variable named at node n, which an assignment
+   names at its left side; a name that was not
+   resolved to a symbol (see nodeSymbol) is an
+   error */
+static int varLoc( NodeId n )
+{ TreeNode * t = node(n);
+  Bucket b;
+  if (t->nodekind == StmtK && t->kind.stmt == AssignK)
+  { n = t->child[0];
+    t = node(n);
+  }
+  b = nodeSymbol(n);
+  if (b == NULL)
+  { fprintf(listing,"Error: no location for %s at line %d\n",
+            t->attr.name, lineOf(t->offset));
+    Error = TRUE;
+    return 0;
+  }
+  return b->memloc;
+}
+
+/* The code for a node is generated in three parts,
+ * by hooks of the tree walker (see walk.h): genPre
+ * before its children, genIn after each of them and
+ * genPost after the last. A node keeps the locations
+ * it must back-patch in the local slots of its frame
+ */
 
-/* Procedure genStmt generates code at a statement node */
-static void genStmt( TreeNode * tree)
-{ TreeNode * p1, * p2, * p3;
-  int savedLoc1,savedLoc2,currentLoc;
-  int loc;
+/* Function genStmtPre generates code at a statement
+ * node before its children, and returns the children
+ * to generate code for
+ */
+static int genStmtPre( WalkFrame * f )
+{ TreeNode * tree = node(f->node);
   switch (tree->kind.stmt) {
 
       case IfK :
          if (TraceCode) emitComment("-> if") ;
-         p1 = tree->child[0] ;
-         p2 = tree->child[1] ;
-         p3 = tree->child[2] ;
-         /* generate code for test expression */
-         cGen(p1);
-         savedLoc1 = emitSkip(1) ;
+         /* generate code for test expression, then
+            part and else part */
+         return CHILD(0) | CHILD(1) | CHILD(2);
+
+      case RepeatK:
+         if (TraceCode) emitComment("-> repeat") ;
+         f->local[0] = emitSkip(0);
+         emitComment("repeat: jump after body comes back here");
+         /* generate code for body, then test */
+         return CHILD(0) | CHILD(1);
+
+      case AssignK:
+         if (TraceCode) emitComment("-> assign") ;
+         /* generate code for rhs */
+         return CHILD(0);
+
+      case ReadK:
+         emitRO("IN",ac,0,0,"read integer value");
+         emitRM("ST",ac,varLoc(f->node),gp,"read: store value");
+         return 0;
+      case WriteK:
+         /* generate code for expression to write */
+         return CHILD(0);
+      default:
+         return 0;
+    }
+} /* genStmtPre */
+
+/* Procedure genStmtIn generates code at a statement
+ * node after its child i
+ */
+static void genStmtIn( WalkFrame * f, int i )
+{ TreeNode * tree = node(f->node);
+  int currentLoc;
+  if (tree->kind.stmt != IfK) return;
+  switch (i) {
+      case 0 :
+         f->local[0] = emitSkip(1) ;
          emitComment("if: jump to else belongs here");
-         /* recurse on then part */
-         cGen(p2);
-         savedLoc2 = emitSkip(1) ;
+         break;
+      case 1 :
+         f->local[1] = emitSkip(1) ;
          emitComment("if: jump to end belongs here");
          currentLoc = emitSkip(0) ;
-         emitBackup(savedLoc1) ;
+         emitBackup(f->local[0]) ;
          emitRM_Abs("JEQ",ac,currentLoc,"if: jmp to else");
          emitRestore() ;
-         /* recurse on else part */
-         cGen(p3);
+         break;
+      case 2 :
          currentLoc = emitSkip(0) ;
-         emitBackup(savedLoc2) ;
+         emitBackup(f->local[1]) ;
          emitRM_Abs("LDA",pc,currentLoc,"jmp to end") ;
          emitRestore() ;
+         break;
+    }
+} /* genStmtIn */
+
+/* Procedure genStmtPost generates code at a
+ * statement node after its children
+ */
+static void genStmtPost( WalkFrame * f )
+{ TreeNode * tree = node(f->node);
+  switch (tree->kind.stmt) {
+
+      case IfK :
          if (TraceCode)  emitComment("<- if") ;
          break; /* if_k */
 
       case RepeatK:
-         if (TraceCode) emitComment("-> repeat") ;
-         p1 = tree->child[0] ;
-         p2 = tree->child[1] ;
-         savedLoc1 = emitSkip(0);
-         emitComment("repeat: jump after body comes back here");
-         /* generate code for body */
-         cGen(p1);
-         /* generate code for test */
-         cGen(p2);
-         emitRM_Abs("JEQ",ac,savedLoc1,"repeat: jmp back to body");
+         emitRM_Abs("JEQ",ac,f->local[0],"repeat: jmp back to body");
          if (TraceCode)  emitComment("<- repeat") ;
          break; /* repeat */
 
       case AssignK:
-         if (TraceCode) emitComment("-> assign") ;
-         /* generate code for rhs */
-         cGen(tree->child[0]);
          /* now store value */
-         //loc = st_lookup(tree->attr.name);
-         emitRM("ST",ac,loc,gp,"assign: store value");
+         emitRM("ST",ac,varLoc(f->node),gp,"assign: store value");
          if (TraceCode)  emitComment("<- assign") ;
          break; /* assign_k */
 
-      case ReadK:
-         emitRO("IN",ac,0,0,"read integer value");
-         //loc = st_lookup(tree->attr.name);
-         emitRM("ST",ac,loc,gp,"read: store value");
-         break;
       case WriteK:
-         /* generate code for expression to write */
-         cGen(tree->child[0]);
          /* now output it */
          emitRO("OUT",ac,0,0,"write ac");
          break;
       default:
          break;
     }
-} /* genStmt */
+} /* genStmtPost */
 
-/* Procedure genExp generates code at an expression node */
-static void genExp( TreeNode * tree)
-{ int loc;
-  TreeNode * p1, * p2;
+/* Function genExpPre generates code at an expression
+ * node before its children, and returns the children
+ * to generate code for
+ */
+static int genExpPre( WalkFrame * f )
+{ TreeNode * tree = node(f->node);
   switch (tree->kind.exp) {
 
     case ConstK :
@@ -105,82 +161,112 @@ static void genExp( TreeNode * tree)
       /* gen code to load integer constant using LDC */
       emitRM("LDC",ac,tree->attr.val,0,"load const");
       if (TraceCode)  emitComment("<- Const") ;
-      break; /* ConstK */
+      return 0; /* ConstK */
     
     case IdK :
       if (TraceCode) emitComment("-> Id") ;
-      //loc = st_lookup(tree->attr.name);
-      emitRM("LD",ac,loc,gp,"load id value");
+      emitRM("LD",ac,varLoc(f->node),gp,"load id value");
       if (TraceCode)  emitComment("<- Id") ;
-      break; /* IdK */
+      return 0; /* IdK */
 
     case OpK :
-         if (TraceCode) emitComment("-> Op") ;
-         p1 = tree->child[0];
-         p2 = tree->child[1];
-         /* gen code for ac = left arg */
-         cGen(p1);
-         /* gen code to push left operand */
-         emitRM("ST",ac,tmpOffset--,mp,"op: push left");
-         /* gen code for ac = right operand */
-         cGen(p2);
-         /* now load left operand */
-         emitRM("LD",ac1,++tmpOffset,mp,"op: load left");
-         switch (tree->attr.op) {
-            case PLUS :
-               emitRO("ADD",ac,ac1,ac,"op +");
-               break;
-            case MINUS :
-               emitRO("SUB",ac,ac1,ac,"op -");
-               break;
-            case TIMES :
-               emitRO("MUL",ac,ac1,ac,"op *");
-               break;
-            case OVER :
-               emitRO("DIV",ac,ac1,ac,"op /");
-               break;
-            case LT :
-               emitRO("SUB",ac,ac1,ac,"op <") ;
-               emitRM("JLT",ac,2,pc,"br if true") ;
-               emitRM("LDC",ac,0,ac,"false case") ;
-               emitRM("LDA",pc,1,pc,"unconditional jmp") ;
-               emitRM("LDC",ac,1,ac,"true case") ;
-               break;
-            case EQ :
-               emitRO("SUB",ac,ac1,ac,"op ==") ;
-               emitRM("JEQ",ac,2,pc,"br if true");
-               emitRM("LDC",ac,0,ac,"false case") ;
-               emitRM("LDA",pc,1,pc,"unconditional jmp") ;
-               emitRM("LDC",ac,1,ac,"true case") ;
-               break;
-            default:
-               emitComment("BUG: Unknown operator");
-               break;
-         } /* case op */
-         if (TraceCode)  emitComment("<- Op") ;
-         break; /* OpK */
+      if (TraceCode) emitComment("-> Op") ;
+      /* gen code for ac = left arg, then right */
+      return CHILD(0) | CHILD(1);
 
     default:
-      break;
+      return 0;
   }
-} /* genExp */
+} /* genExpPre */
 
-/* Procedure cGen recursively generates code by
- * tree traversal
+/* Procedure genExpIn generates code at an expression
+ * node after its child i
  */
-static void cGen( TreeNode * tree)
-{ if (tree != NULL)
-  { switch (tree->nodekind) {
-      case StmtK:
-        genStmt(tree);
+static void genExpIn( WalkFrame * f, int i )
+{ TreeNode * tree = node(f->node);
+  if ((tree->kind.exp == OpK) && (i == 0))
+    /* gen code to push left operand */
+    emitRM("ST",ac,tmpOffset--,mp,"op: push left");
+} /* genExpIn */
+
+/* Procedure genExpPost generates code at an
+ * expression node after its children
+ */
+static void genExpPost( WalkFrame * f )
+{ TreeNode * tree = node(f->node);
+  if (tree->kind.exp != OpK) return;
+  /* now load left operand */
+  emitRM("LD",ac1,++tmpOffset,mp,"op: load left");
+  switch (tree->attr.op) {
+     case PLUS :
+        emitRO("ADD",ac,ac1,ac,"op +");
         break;
-      case ExpK:
-        genExp(tree);
+     case MINUS :
+        emitRO("SUB",ac,ac1,ac,"op -");
         break;
-      default:
+     case TIMES :
+        emitRO("MUL",ac,ac1,ac,"op *");
         break;
-    }
-    cGen(tree->sibling);
+     case OVER :
+        emitRO("DIV",ac,ac1,ac,"op /");
+        break;
+     case LT :
+        emitRO("SUB",ac,ac1,ac,"op <") ;
+        emitRM("JLT",ac,2,pc,"br if true") ;
+        emitRM("LDC",ac,0,ac,"false case") ;
+        emitRM("LDA",pc,1,pc,"unconditional jmp") ;
+        emitRM("LDC",ac,1,ac,"true case") ;
+        break;
+     case EQ :
+        emitRO("SUB",ac,ac1,ac,"op ==") ;
+        emitRM("JEQ",ac,2,pc,"br if true");
+        emitRM("LDC",ac,0,ac,"false case") ;
+        emitRM("LDA",pc,1,pc,"unconditional jmp") ;
+        emitRM("LDC",ac,1,ac,"true case") ;
+        break;
+     default:
+        emitComment("BUG: Unknown operator");
+        break;
+  } /* case op */
+  if (TraceCode)  emitComment("<- Op") ;
+} /* genExpPost */
+
+/* the hooks dispatch on the kind of node */
+
+static int genPre( WalkFrame * f )
+{ switch (node(f->node)->nodekind) {
+    case StmtK:
+      return genStmtPre(f);
+    case ExpK:
+      return genExpPre(f);
+    default:
+      return 0;
+  }
+}
+
+static void genIn( WalkFrame * f, int i )
+{ switch (node(f->node)->nodekind) {
+    case StmtK:
+      genStmtIn(f,i);
+      break;
+    case ExpK:
+      genExpIn(f,i);
+      break;
+    default:
+      break;
+  }
+}
+
+static void genPost( WalkFrame * f )
+{ switch (node(f->node)->nodekind) {
+    case StmtK:
+      genStmtPost(f);
+      break;
+    case ExpK:
+      genExpPost(f);
+      break;
+    default:
+      break;
   }
 }
 
@@ -193,8 +279,9 @@ static void cGen( TreeNode * tree)
  * of the code file, and is used to print the
  * file name as a comment in the code file
  */
-void codeGen(TreeNode * syntaxTree, char * codefile)
-{  char * s = malloc(strlen(codefile)+7);
+void codeGen(NodeId syntaxTree, char * codefile)
+{  static const WalkProcs procs = {genPre,genIn,genPost};
+   char * s = malloc(strlen(codefile)+7);
    strcpy(s,"File: ");
    strcat(s,codefile);
    emitComment("TINY Compilation to TM Code");
@@ -205,7 +292,7 @@ void codeGen(TreeNode * syntaxTree, char * codefile)
    emitRM("ST",ac,0,ac,"clear location 0");
    emitComment("End of standard prelude.");
    /* generate code for TINY program */
-   cGen(syntaxTree);
+   walkTree(syntaxTree,&procs);
    /* finish */
    emitComment("End of execution.");
    emitRO("HALT",0,0,0,"");
@@ -11,284 +11,253 @@
 #include "util.h"
 #include "scan.h"
 #include "parse.h"
+#include "intern.h"
+#include "lineidx.h"
+#include "source.h"
 
-#define YYSTYPE TreeNode *
-static char * savedName; /* for use in assignments */
-static int savedLineNo;  /* ditto */
-static TreeNode * savedTree; /* stores syntax tree for later return */
-static int yylex(void); // added 11/2/11 to ensure no conflict with lex
-static int savedSize;
-static char * savedType;
+/* a location is the offset of a token in srcText
+ * (see scan.h); a rule is located at its first
+ * symbol, and an empty one where the symbol
+ * before it is */
+#define YYLTYPE int
+#define YYLLOC_DEFAULT(Cur,Rhs,N) \
+  ((Cur) = (N) ? YYRHSLOC(Rhs,1) : YYRHSLOC(Rhs,0))
+static NodeId savedTree; /* stores syntax tree for later return */
+/* the token being pushed, for yyerror */
+static const TokenRec * pushedToken;
+static char * nullName; /* name of a void parameter list */
+static int numValue(const TokenRec * tok);
+int yyerror(char * message);
+static NodeId appendList(NodeId last, NodeId t);
+static NodeId closeList(NodeId last);
+static NodeId newOp(NodeId left, TokenType op, NodeId right);
 
 %}
 
+/* every node is made by the reduction that completes
+ * it, from the values of its symbols: an ID carries
+ * its interned name and a NUM its value, so no action
+ * runs before the parser knows which rule it is in.
+ * The members are the base types of NodeId and
+ * ExpType, which y.tab.h comes before */
+%union { unsigned int node; char * name; int val; int type; }
+
 %token IF ELSE WHILE RETURN INT VOID
 %token THEN END REPEAT UNTIL READ WRITE 
-%token ID NUM 
+%token <name> ID
+%token <val> NUM
 %token ASSIGN EQ NE LT LE GE GT PLUS MINUS TIMES OVER LPAREN RPAREN LBRACE RBRACE LCURLY RCURLY SEMI COMMA
 %token ERROR 
 
-%nonassoc LOWER_THAN_ELSE
-%nonassoc ELSE
+%type <node> decl_list decl var_decl fun_decl params param_list param
+%type <node> comp_stmt local_decl stmt_list stmt matched_stmt unmatched_stmt
+%type <node> exp_stmt ret_stmt exp var simple_exp term factor call args arg_list
+%type <type> type_spec
+
+%locations
+%define api.push-pull push
+%expect 0
 
-%% /* Grammar for TINY */
+%% /* Grammar for C-Minus */
 
 program     : decl_list
-                { savedTree = $1;}
+                { savedTree = closeList($1);}
             ;
 decl_list   : decl_list decl
-                { YYSTYPE t = $1;
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = $2;
-                    $$ = $1; }
-                  else $$ = $2;
+                { $$ = appendList($1,$2);
+                  addTopDecl($2,@2);
+                }
+            | decl
+                { $$ = appendList(NONODE,$1);
+                  addTopDecl($1,@1);
                 }
-            | decl  { $$ = $1; }
             ;
 decl        : var_decl
                 { $$ = $1; }
             | fun_decl
                 { $$ = $1; }
             ;
-var_decl    : type_spec id SEMI
+var_decl    : type_spec ID SEMI
                 { $$ = newStmtNode(VarDeclK);
-                  $$->attr.name = savedName;
-                  $$->attr.type = savedType;
-                  $$->lineno = lineno;
+                  node($$)->attr.name = $2;
+                  node($$)->decl = $1;
+                  node($$)->offset = @2;
                 }
-            | type_spec id LBRACE num RBRACE SEMI
+            | type_spec ID LBRACE NUM RBRACE SEMI
                 { $$ = newStmtNode(ArrVarDeclK);
-                  $$->attr.name = savedName;
-                  $$->attr.val = savedSize;
-                  $$->attr.type = savedType;
-                  $$->lineno = lineno;
+                  node($$)->attr.name = $2;
+                  setArraySize($$,$4);
+                  node($$)->decl = $1;
+                  node($$)->offset = @2;
                 }
             ;
 type_spec   : INT
-                { savedType = copyString(tokenString);}
+                { $$ = Integer;}
             | VOID
-                { savedType = copyString(tokenString);}
+                { $$ = Void;}
             ;
-fun_decl    : type_spec id
+fun_decl    : type_spec ID LPAREN params RPAREN comp_stmt
                 { $$ = newStmtNode(FunK);
-                  $$->attr.name = savedName;
-                  $$->attr.type = savedType;
-                }
-              LPAREN params RPAREN comp_stmt
-                { $$ = $3;
-                  $$->lineno = lineno;
-                  $$->child[0] = $5;
-                  $$->child[1] = $7;
+                  node($$)->attr.name = $2;
+                  node($$)->decl = $1;
+                  node($$)->offset = @2;
+                  node($$)->child[0] = $4;
+                  node($$)->child[1] = $6;
                 }
             ;
 params      : param_list
-                { $$ = $1; }
+                { $$ = closeList($1); }
             | VOID
                 { $$ = newStmtNode(ParamK);
-                  $$->attr.name = "(null)";
-                  $$->attr.type = "void";
-                  $$->lineno = lineno;
+                  node($$)->attr.name = nullName;
+                  node($$)->decl = Void;
+                  node($$)->offset = @1;
                 }
             ;
 param_list  : param_list COMMA param
-                { YYSTYPE t = $1;
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = $3;
-                    $$ = $1; }
-                  else $$ = $3;
-                }
+                { $$ = appendList($1,$3); }
             | param
-                { $$ = $1; }
+                { $$ = appendList(NONODE,$1); }
             ;
-param       : type_spec id
+param       : type_spec ID
                 { $$ = newStmtNode(ParamK);
-                  $$->attr.name = savedName;
-                  $$->attr.type = savedType;
-                  $$->lineno = lineno;
+                  node($$)->attr.name = $2;
+                  node($$)->decl = $1;
+                  node($$)->offset = @2;
                 }
-            | type_spec id LBRACE RBRACE
+            | type_spec ID LBRACE RBRACE
                 { $$ = newStmtNode(ArrParamK);
-                  $$->attr.name = savedName;
-                  $$->attr.type = savedType;
-                  $$->lineno = lineno;
+                  node($$)->attr.name = $2;
+                  node($$)->decl = $1;
+                  node($$)->offset = @2;
                 }
             ;
 comp_stmt   : LCURLY local_decl stmt_list RCURLY
                 { $$ = newStmtNode(CompK);
-                  $$->child[0] = $2;
-                  $$->child[1] = $3;
+                  node($$)->offset = @1;
+                  node($$)->child[0] = closeList($2);
+                  node($$)->child[1] = closeList($3);
                 }
             ;
 local_decl  : local_decl var_decl
-                { YYSTYPE t = $1;
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = $2;
-                    $$ = $1; }
-                  else $$ = $2;
-                }
-            | { $$ = NULL; }
+                { $$ = appendList($1,$2); }
+            | { $$ = NONODE; }
             ;
 stmt_list   : stmt_list stmt
-                { YYSTYPE t = $1;
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = $2;
-                    $$ = $1; }
-                  else $$ = $2;
-                }
-            | { $$ = NULL; }
+                { $$ = appendList($1,$2); }
+            | { $$ = NONODE; }
             ;
-stmt        : exp_stmt
+/* an else goes with the nearest if: the statement
+ * between an if's test and its else must be matched,
+ * that is have no if without an else that the else
+ * could go with instead */
+stmt        : matched_stmt
                 { $$ = $1; }
-            | comp_stmt
+            | unmatched_stmt
                 { $$ = $1; }
-            | sel_stmt
+            ;
+matched_stmt : exp_stmt
                 { $$ = $1; }
-            | iter_stmt
+            | comp_stmt
                 { $$ = $1; }
             | ret_stmt
                 { $$ = $1; }
+            | IF LPAREN exp RPAREN matched_stmt ELSE matched_stmt
+                { $$ = newStmtNode(IfK);
+                  node($$)->offset = @1;
+                  node($$)->child[0] = $3;
+                  node($$)->child[1] = $5;
+                  node($$)->child[2] = $7;
+                }
+            | WHILE LPAREN exp RPAREN matched_stmt
+                { $$ = newStmtNode(WhileK);
+                  node($$)->offset = @1;
+                  node($$)->child[0] = $3;
+                  node($$)->child[1] = $5;
+                }
             ;
-exp_stmt    : exp SEMI
-                { $$ = $1; }
-            | SEMI
-                { $$ = NULL; }
-            ;
-sel_stmt    : IF LPAREN exp RPAREN stmt %prec LOWER_THAN_ELSE
+unmatched_stmt : IF LPAREN exp RPAREN stmt
                 { $$ = newStmtNode(IfK);
-                  $$->child[0] = $3;
-                  $$->child[1] = $5;
-                  $$->child[2] = NULL;
+                  node($$)->offset = @1;
+                  node($$)->child[0] = $3;
+                  node($$)->child[1] = $5;
+                  node($$)->child[2] = NONODE;
                 }
-            | IF LPAREN exp RPAREN stmt ELSE stmt
+            | IF LPAREN exp RPAREN matched_stmt ELSE unmatched_stmt
                 { $$ = newStmtNode(IfK);
-                  $$->child[0] = $3;
-                  $$->child[1] = $5;
-                  $$->child[2] = $7;
+                  node($$)->offset = @1;
+                  node($$)->child[0] = $3;
+                  node($$)->child[1] = $5;
+                  node($$)->child[2] = $7;
                 }
-            ;
-iter_stmt   : WHILE LPAREN exp RPAREN stmt
+            | WHILE LPAREN exp RPAREN unmatched_stmt
                 { $$ = newStmtNode(WhileK);
-                  $$->child[0] = $3;
-                  $$->child[1] = $5;
+                  node($$)->offset = @1;
+                  node($$)->child[0] = $3;
+                  node($$)->child[1] = $5;
                 }
             ;
+exp_stmt    : exp SEMI
+                { $$ = $1; }
+            | SEMI
+                { $$ = NONODE; }
+            ;
 ret_stmt    : RETURN SEMI
                 { $$ = newStmtNode(RetK);
-                  $$->child[0] = NULL;
+                  node($$)->offset = @1;
+                  node($$)->child[0] = NONODE;
                 }
             | RETURN exp SEMI
                 { $$ = newStmtNode(RetK);
-                  $$->child[0] = $2;
+                  node($$)->offset = @1;
+                  node($$)->child[0] = $2;
                 }
             ;
-exp         : var 
+exp         : var ASSIGN exp
                 { $$ = newStmtNode(AssignK);
-                  $$->attr.name = savedName; 
-                }
-              ASSIGN exp
-                { 
-                  $$ = $2;
-                  $$->child[0] = $1;
-                  $$->child[1] = $4;
-                  $$->lineno = $1->lineno;
+                  node($$)->attr.name = node($1)->attr.name;
+                  node($$)->child[0] = $1;
+                  node($$)->child[1] = $3;
+                  node($$)->offset = node($1)->offset;
                 }
             | simple_exp LT simple_exp 
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = LT;
-                  $$->lineno = $1->lineno;
-                }
+                { $$ = newOp($1,LT,$3); }
             | simple_exp EQ simple_exp
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = EQ;
-                  $$->lineno = $1->lineno;
-                }
+                { $$ = newOp($1,EQ,$3); }
             | simple_exp NE simple_exp
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = NE;
-                  $$->lineno = $1->lineno;
-                }
+                { $$ = newOp($1,NE,$3); }
             | simple_exp LE simple_exp
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = LE;
-                  $$->lineno = $1->lineno;
-                }
+                { $$ = newOp($1,LE,$3); }
             | simple_exp GT simple_exp
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = GT;
-                  $$->lineno = $1->lineno;
-                }
+                { $$ = newOp($1,GT,$3); }
             | simple_exp GE simple_exp
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = GE;
-                  $$->lineno = $1->lineno;
-                }
+                { $$ = newOp($1,GE,$3); }
             | simple_exp
                 { $$ = $1; }
             ;
-var         : id
+var         : ID
                 { $$ = newExpNode(IdK);
-                  $$->attr.name = savedName;
-                  $$->lineno = lineno;
+                  node($$)->attr.name = $1;
+                  node($$)->offset = @1;
                 }
-            | id
+            | ID LBRACE simple_exp RBRACE
                 { $$ = newExpNode(ArrIdK);
-                  $$->attr.name = savedName;
-                }
-             LBRACE simple_exp RBRACE
-                { $$ = $2;
-                  $$->child[0] = $4;
-                  $$->lineno = lineno;
+                  node($$)->attr.name = $1;
+                  node($$)->offset = @1;
+                  node($$)->child[0] = $3;
                 }
             ;
 simple_exp  : simple_exp PLUS term 
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = PLUS;
-                  $$->lineno = $1->lineno;
-                }
+                { $$ = newOp($1,PLUS,$3); }
             | simple_exp MINUS term
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = MINUS;
-                  $$->lineno = $1->lineno;
-                } 
+                { $$ = newOp($1,MINUS,$3); }
             | term
                 { $$ = $1; }
             ;
 term        : term TIMES factor
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = TIMES;
-                }
+                { $$ = newOp($1,TIMES,$3); }
             | term OVER factor
-                { $$ = newExpNode(OpK);
-                  $$->child[0] = $1;
-                  $$->child[1] = $3;
-                  $$->attr.op = OVER;
-                }
+                { $$ = newOp($1,OVER,$3); }
             | factor
                 { $$ = $1; }
             ;
@@ -300,64 +269,178 @@ factor      : LPAREN exp RPAREN
                 { $$ = $1; }
             | NUM
                 { $$ = newExpNode(ConstK);
-                  $$->attr.val = atoi(tokenString);
+                  node($$)->attr.val = $1;
+                  node($$)->offset = @1;
                 }
             ;
-call        : id
+call        : ID LPAREN args RPAREN
                 { $$ = newExpNode(CallK);
-                  $$->attr.name = savedName;
-                }
-              LPAREN args RPAREN
-                { $$ = $2;
-                  $$->child[0] = $4;
+                  node($$)->attr.name = $1;
+                  node($$)->offset = @1;
+                  node($$)->child[0] = $3;
                 }
             ;
 args        : arg_list
-                { $$ = $1;}
-            | { $$ = NULL; }
+                { $$ = closeList($1);}
+            | { $$ = NONODE; }
             ;
 arg_list    : arg_list COMMA exp
-                { YYSTYPE t = $1;
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = $3;
-                    $$ = $1; }
-                  else $$ = $3;
-                }
+                { $$ = appendList($1,$3); }
             | exp
-                { $$ = $1; }
-            ;
-id          : ID
-                { savedName = copyString(tokenString);
-                  savedLineNo = lineno;
-                }
-            ;
-
-num         : NUM
-                {savedSize = atoi(tokenString);
-                  savedLineNo = lineno;
-                }
+                { $$ = appendList(NONODE,$1); }
             ;
 
 %%
 
+/* A list under construction is kept circular and is
+ * referred to by its last node, whose sibling is the
+ * first; appendList then adds a node in constant time
+ * instead of walking the siblings to the end, and
+ * returns the new last node. closeList breaks the
+ * circle once the list is complete and returns its
+ * first node, as the syntax tree expects
+ */
+static NodeId appendList(NodeId last, NodeId t)
+{ if (t == NONODE) return last;
+  if (last == NONODE) node(t)->sibling = t;
+  else
+  { node(t)->sibling = node(last)->sibling;
+    node(last)->sibling = t;
+  }
+  return t;
+}
+
+static NodeId closeList(NodeId last)
+{ NodeId first;
+  if (last == NONODE) return NONODE;
+  first = node(last)->sibling;
+  node(last)->sibling = NONODE;
+  return first;
+}
+
+/* newOp makes the node of the binary operation op,
+ * located at its left operand */
+static NodeId newOp(NodeId left, TokenType op, NodeId right)
+{ NodeId t = newExpNode(OpK);
+  node(t)->child[0] = left;
+  node(t)->child[1] = right;
+  node(t)->attr.op = op;
+  node(t)->offset = node(left)->offset;
+  return t;
+}
+
+/* numValue returns the value of the NUM lexeme of
+ * tok, as strtol gives it, reading nothing past the
+ * lexeme: a scanner on another thread (see
+ * pipeparse.h) may be writing the byte after it
+ */
+static int numValue(const TokenRec * tok)
+{ const char * p = srcText + tok->offset;
+  long v = 0;
+  int i;
+  for (i=0;i<tok->length;i++)
+  { int d = p[i] - '0';
+    if (v > (LONG_MAX - d) / 10) v = LONG_MAX;
+    else v = 10*v + d;
+  }
+  return (int) v;
+}
+
 int yyerror(char * message)
-{ fprintf(listing,"Syntax error at line %d: %s\n",lineno,message);
+{ fprintf(listing,"Syntax error at line %d: %s\n",lineOf(yylloc),message);
   fprintf(listing,"Current token: ");
-  printToken(yychar,tokenString);
+  if (pushedToken->length > 0)
+    printTokenSpan(yychar,srcText+pushedToken->offset,pushedToken->length);
+  else
+    printToken(yychar,"");
   Error = TRUE;
   return 0;
 }
 
-/* yylex calls getToken to make Yacc/Bison output
- * compatible with ealier versions of the TINY scanner
+/* a push parse in progress */
+struct parseState
+   { yypstate * yyps;
+     ParseStatus status;
+     int offset; /* location of the last token pushed */
+   };
+
+/* Function parseStart begins a push parse */
+ParseState parseStart(void)
+{ ParseState ps = (ParseState) malloc(sizeof(struct parseState));
+  if (ps == NULL)
+  { fprintf(listing,"Out of memory error starting parse\n");
+    Error = TRUE;
+    return NULL;
+  }
+  ps->yyps = yypstate_new(); /* NULL while another parse is active */
+  if (ps->yyps == NULL)
+  { fprintf(listing,"Could not start parse\n");
+    Error = TRUE;
+    free(ps);
+    return NULL;
+  }
+  ps->status = ParseMore;
+  ps->offset = 0;
+  savedTree = NONODE;
+  nullName = internName("(null)",6);
+  return ps;
+}
+
+/* Function parsePush hands the n tokens at toks to
+ * the parse ps, in order
  */
-static int yylex(void)
-{ return getToken(); }
+ParseStatus parsePush(ParseState ps, const TokenRec * toks, int n)
+{ int i;
+  for (i=0;(i<n) && (ps->status == ParseMore);i++)
+  { int result;
+    pushedToken = &toks[i];
+    ps->offset = toks[i].offset;
+    /* the parser is not pure: the token is
+     * passed in yychar, yylval and yylloc */
+    yychar = toks[i].kind;
+    if (yychar == ID) yylval.name = toks[i].name;
+    else if (yychar == NUM) yylval.val = numValue(&toks[i]);
+    else yylval.node = NONODE;
+    yylloc = toks[i].offset;
+    result = yypush_parse(ps->yyps);
+    if (result == 0) ps->status = ParseDone;
+    else if (result != YYPUSH_MORE) ps->status = ParseError;
+  }
+  pushedToken = NULL;
+  return ps->status;
+}
 
-TreeNode * parse(void)
-{ yyparse();
+/* Function parseFinish ends the parse ps, returning
+ * its syntax tree
+ */
+NodeId parseFinish(ParseState ps)
+{ if (ps->status == ParseMore)
+  { /* the input stopped short: end it here */
+    TokenRec eof;
+    eof.kind = YYEOF;
+    eof.offset = ps->offset;
+    eof.length = 0;
+    eof.name = NULL;
+    parsePush(ps,&eof,1);
+  }
+  yypstate_delete(ps->yyps);
+  free(ps);
   return savedTree;
 }
 
+/* Function yaccParse pulls the tokens of the source
+ * from getToken and pushes them one at a time
+ */
+NodeId yaccParse(void)
+{ ParseState ps = parseStart();
+  TokenRec tok;
+  if (ps == NULL) return NONODE;
+  do
+  { tok.kind = getToken();
+    tok.offset = tokenOffset;
+    tok.length = tokenLength;
+    tok.name = tokenName;
+  } while (parsePush(ps,&tok,1) == ParseMore);
+  return parseFinish(ps);
+}
+
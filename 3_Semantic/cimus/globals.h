@@ -56,8 +56,6 @@ extern FILE* source; /* source code text file */
 extern FILE* listing; /* listing output text file */
 extern FILE* code; /* code text file for TM simulator */
 
-extern int lineno; /* source line number for listing */
-
 /**************************************************/
 /***********   Syntax tree for parsing ************/
 /**************************************************/
@@ -72,20 +70,30 @@ typedef enum {Void,Integer,IntegerArray} ExpType;
 
 #define MAXCHILDREN 3
 
-struct ScopeListRec;
+/* Nodes live in an array owned by the compilation
+ * (see util.h) and refer to each other by NodeId,
+ * their 32-bit index in it; node turns a NodeId
+ * into a TreeNode *. NONODE is the missing node.
+ * Kinds and types are kept in a byte each, and the
+ * attributes few nodes need (the size of an array
+ * declaration, the scope the analyzer finds a node
+ * in) in side tables, also in util.h
+ */
+typedef unsigned int NodeId;
+
+#define NONODE 0
 
 typedef struct treeNode
-   { struct treeNode * child[MAXCHILDREN];
-     struct treeNode * sibling;
-     int lineno;
-     NodeKind nodekind;
-     union { StmtKind stmt; ExpKind exp;} kind;
-     struct { TokenType op;
+   { NodeId child[MAXCHILDREN];
+     NodeId sibling;
+     int offset; /* position in srcText, -1 if none; see lineidx.h */
+     unsigned char nodekind; /* a NodeKind */
+     union { unsigned char stmt; unsigned char exp;} kind; /* a StmtKind or ExpKind */
+     unsigned char type; /* an ExpType, for type checking of exps */
+     unsigned char decl; /* an ExpType: Integer or Void as declared */
+     union { TokenType op;
              int val;
-             char * name;
-             char * type; } attr;
-     ExpType type; /* for type checking of exps */
-     struct ScopeListRec *scope;
+             char * name; } attr;
    } TreeNode;
 
 /**************************************************/
@@ -104,6 +112,40 @@ extern int EchoSource;
  */
 extern int TraceScan;
 
+/* MapSource = TRUE causes the scanner to map the
+ * source file into memory when it is a regular file;
+ * otherwise the file is read into a buffer. Either
+ * way the whole source is scanned in place
+ */
+extern int MapSource;
+
+/* PipeParse = TRUE causes the source to be scanned
+ * on a thread of its own while it is parsed, the
+ * tokens passing between them through a ring (see
+ * pipeparse.h)
+ */
+extern int PipeParse;
+
+/* YaccParse = TRUE causes the source to be parsed
+ * by the LALR parser generated from cminus.y rather
+ * than the recursive-descent parser (see parse.h)
+ */
+extern int YaccParse;
+
+/* CacheAst = TRUE causes the syntax tree to be kept
+ * in a .cmast file beside the source, and read back
+ * from it instead of parsing while the source is
+ * unchanged (see astcache.h)
+ */
+extern int CacheAst;
+
+/* IncrementalParse = TRUE causes a .cmast file kept
+ * for an earlier version of the source to be brought
+ * up to date by parsing again only the top-level
+ * declarations whose text changed (see astcache.h)
+ */
+extern int IncrementalParse;
+
 /* TraceParse = TRUE causes the syntax tree to be
  * printed to the listing file in linearized form
  * (using indents for children)
@@ -0,0 +1,110 @@
+/****************************************************/
+/* File: intern.c                                   */
+/* Identifier interning pool shared by the scanner, */
+/* the parser and the symbol table                  */
+/****************************************************/
+
+#include <stddef.h>
+#include "globals.h"
+#include "intern.h"
+#include "scan.h"
+#include "lineidx.h"
+
+/* INITSLOTS = initial number of hash chains; the
+   table doubles whenever it holds as many names
+   as it has chains */
+#define INITSLOTS 256
+
+/* The record in front of each interned name: the
+ * text follows the header, so a name can be
+ * handed out as a plain char * and its header
+ * recovered from it by nameRec
+ */
+typedef struct NameRec
+   { struct NameRec * next;
+     void * binding; /* see nameBinding */
+     unsigned int hash;
+     int len;
+     char text[];
+   } NameRec;
+
+#define nameRec(name) \
+   ((NameRec *) ((char *) (name) - offsetof(NameRec,text)))
+
+static NameRec ** slots = NULL;
+static unsigned int nSlots = 0;
+static unsigned int nNames = 0;
+
+/* the hash function (FNV-1a) */
+static unsigned int hashText( const char * s, int len )
+{ unsigned int h = 2166136261u;
+  int i;
+  for (i=0;i<len;i++)
+    h = (h ^ (unsigned char) s[i]) * 16777619u;
+  return h;
+}
+
+/* grow doubles the number of chains, relinking
+   the names already in the pool */
+static void grow( void )
+{ unsigned int n = nSlots ? nSlots * 2 : INITSLOTS;
+  NameRec ** t = (NameRec **) calloc(n,sizeof(NameRec *));
+  unsigned int i;
+  if (t == NULL)
+  { fprintf(listing,"Out of memory error at line %d\n",lineOf(tokenOffset));
+    exit(1);
+  }
+  for (i=0;i<nSlots;i++)
+  { NameRec * r = slots[i];
+    while (r != NULL)
+    { NameRec * next = r->next;
+      r->next = t[r->hash & (n-1)];
+      t[r->hash & (n-1)] = r;
+      r = next;
+    }
+  }
+  free(slots);
+  slots = t;
+  nSlots = n;
+}
+
+/* Function internName returns the interned copy
+ * of the len characters starting at s
+ */
+char * internName( const char * s, int len )
+{ unsigned int h = hashText(s,len);
+  NameRec * r;
+  if (nSlots == 0) grow();
+  for (r = slots[h & (nSlots-1)]; r != NULL; r = r->next)
+    if ((r->hash == h) && (r->len == len) && (memcmp(r->text,s,len) == 0))
+      return r->text;
+  if (nNames >= nSlots) grow();
+  r = (NameRec *) malloc(sizeof(NameRec) + len + 1);
+  if (r == NULL)
+  { fprintf(listing,"Out of memory error at line %d\n",lineOf(tokenOffset));
+    exit(1);
+  }
+  r->binding = NULL;
+  r->hash = h;
+  r->len = len;
+  memcpy(r->text,s,len);
+  r->text[len] = '\0';
+  r->next = slots[h & (nSlots-1)];
+  slots[h & (nSlots-1)] = r;
+  nNames++;
+  return r->text;
+}
+
+/* Function nameHash returns the hash stored with
+ * an interned name
+ */
+unsigned int nameHash( const char * name )
+{ return nameRec(name)->hash;
+}
+
+/* Function nameBinding returns the binding slot
+ * of an interned name
+ */
+void ** nameBinding( const char * name )
+{ return &nameRec(name)->binding;
+}
@@ -0,0 +1,35 @@
+/****************************************************/
+/* File: intern.h                                   */
+/* Identifier interning pool shared by the scanner, */
+/* the parser and the symbol table                  */
+/****************************************************/
+
+#ifndef _INTERN_H_
+#define _INTERN_H_
+
+/* Every identifier is stored in the pool exactly
+ * once, so two interned names are equal exactly
+ * when their pointers are equal, and an interned
+ * name lives until the compiler exits. Each name
+ * carries a hash of its text, computed once when
+ * it first enters the pool
+ */
+
+/* Function internName returns the interned copy
+ * of the len characters starting at s
+ */
+char * internName( const char * s, int len );
+
+/* Function nameHash returns the hash stored with
+ * an interned name
+ */
+unsigned int nameHash( const char * name );
+
+/* Function nameBinding returns the slot kept with
+ * an interned name for the symbol table, which
+ * holds there the innermost binding of the name
+ * (see st_bound in symtab.h); it starts NULL
+ */
+void ** nameBinding( const char * name );
+
+#endif
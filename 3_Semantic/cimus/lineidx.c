@@ -0,0 +1,88 @@
+/****************************************************/
+/* File: lineidx.c                                  */
+/* Newline index over the source buffer: maps byte  */
+/* offsets in srcText to line and column numbers    */
+/****************************************************/
+
+#include "globals.h"
+#include "source.h"
+#include "lineidx.h"
+
+/* lineStart[i] is the offset in srcText at which
+   line i+1 starts; nLines is the number of lines */
+static long * lineStart = NULL;
+static int nLines = 0;
+
+/* line found by the last lookup: listings ask for
+   lines in nearly increasing order, so most lookups
+   end on it or on the line after it */
+static int lastLine = 0;
+
+/* Function buildLineIndex indexes the line starts
+ * of srcText in one memchr pass over it
+ */
+int buildLineIndex( void )
+{ const char * end = srcText + srcLen;
+  const char * p = srcText;
+  int cap = 1024;
+  free(lineStart);
+  lineStart = (long *) malloc(cap*sizeof(long));
+  if (lineStart == NULL)
+  { fprintf(listing,"Out of memory error indexing lines\n");
+    return FALSE;
+  }
+  lineStart[0] = 0;
+  nLines = 1;
+  lastLine = 0;
+  while ((p = memchr(p,'\n',end-p)) != NULL)
+  { if (nLines == cap)
+    { long * t = (long *) realloc(lineStart,cap*2*sizeof(long));
+      if (t == NULL)
+      { fprintf(listing,"Out of memory error indexing lines\n");
+        return FALSE;
+      }
+      lineStart = t;
+      cap *= 2;
+    }
+    lineStart[nLines++] = (++p) - srcText;
+  }
+  return TRUE;
+}
+
+/* findLine returns the index in lineStart of the
+   line holding offset */
+static int findLine( long offset )
+{ int lo, hi;
+  if (lineStart[lastLine] <= offset)
+  { if ((lastLine+1 == nLines) || (offset < lineStart[lastLine+1]))
+      return lastLine;
+    if ((lastLine+2 == nLines) || (offset < lineStart[lastLine+2]))
+      return ++lastLine;
+  }
+  /* binary search for the last line starting
+     at or before offset */
+  lo = 0;
+  hi = nLines-1;
+  while (lo < hi)
+  { int mid = lo + (hi-lo+1)/2;
+    if (lineStart[mid] <= offset) lo = mid;
+    else hi = mid-1;
+  }
+  return lastLine = lo;
+}
+
+/* Function lineOf returns the line holding the
+ * byte at offset in srcText, counting from 1
+ */
+int lineOf( long offset )
+{ if ((offset < 0) || (lineStart == NULL)) return 0;
+  return findLine(offset) + 1;
+}
+
+/* Function columnOf returns the column of the byte
+ * at offset within its line, counting from 1
+ */
+int columnOf( long offset )
+{ if ((offset < 0) || (lineStart == NULL)) return 0;
+  return (int) (offset - lineStart[findLine(offset)]) + 1;
+}
@@ -21,7 +21,10 @@
 #if NO_PARSE
 #include "scan.h"
 #else
+#include "scan.h"
 #include "parse.h"
+#include "pipeparse.h"
+#include "astcache.h"
 #if !NO_ANALYZE
 #include "analyze.h"
 #if !NO_CODE
@@ -31,7 +34,6 @@
 #endif
 
 /* allocate global variables */
-int lineno = 0;
 FILE * source;
 FILE * listing;
 FILE * code;
@@ -39,14 +41,20 @@ FILE * code;
 /* allocate and set tracing flags */
 int EchoSource = FALSE;
 int TraceScan = FALSE;
+int MapSource = TRUE;
+int PipeParse = FALSE;
+int YaccParse = FALSE;
+int CacheAst = FALSE;
+int IncrementalParse = FALSE;
 int TraceParse = FALSE;
 int TraceAnalyze = TRUE;
 int TraceCode = FALSE;
 
 int Error = FALSE;
 
-main( int argc, char * argv[] )
-{ TreeNode * syntaxTree;
+int main( int argc, char * argv[] )
+{ NodeId syntaxTree;
+  Compilation comp;
   char pgm[120]; /* source code file name */
   if (argc != 2)
     { fprintf(stderr,"usage: %s <filename>\n",argv[0]);
@@ -65,7 +73,18 @@ main( int argc, char * argv[] )
 #if NO_PARSE
   while (getToken()!=ENDFILE);
 #else
-  syntaxTree = parse();
+  beginCompilation(&comp);
+  if (CacheAst)
+  { char * astfile;
+    int fnlen = strcspn(pgm,".");
+    astfile = (char *) calloc(fnlen+7, sizeof(char));
+    strncpy(astfile,pgm,fnlen);
+    strcat(astfile,".cmast");
+    syntaxTree = cachedParse(astfile,NULL);
+    free(astfile);
+  }
+  else
+    syntaxTree = PipeParse ? pipeParse(NULL) : parse();
   if (TraceParse) {
     fprintf(listing,"\nSyntax tree:\n");
     printTree(syntaxTree);
@@ -95,6 +114,7 @@ main( int argc, char * argv[] )
   }
 #endif
 #endif
+  endCompilation(&comp);
 #endif
   fclose(source);
   return 0;
@@ -1,215 +1,434 @@
 /****************************************************/
 /* File: parse.c                                    */
-/* The parser implementation for the TINY compiler  */
+/* The recursive-descent parser implementation      */
+/* for the C-Minus compiler                         */
 /* Compiler Construction: Principles and Practice   */
 /* Kenneth C. Louden                                */
 /****************************************************/
 
+#include <setjmp.h>
 #include "globals.h"
 #include "util.h"
 #include "scan.h"
 #include "parse.h"
+#include "intern.h"
+#include "lineidx.h"
+
+/* MAXNESTING = deepest nesting of statements and
+   expressions parsed, lest the C stack overflow */
+#define MAXNESTING 10000
 
 static TokenType token; /* holds current token */
 
+/* the tree built is the one the actions of cminus.y
+   build, node for node and in the same order: as
+   there, a node is made once all its parts are
+   parsed */
+static NodeId savedTree; /* stores syntax tree for later return */
+static char * nullName; /* name of a void parameter list */
+static int nesting;
+static jmp_buf failed; /* where a syntax error ends the parse */
+
 /* function prototypes for recursive calls */
-static TreeNode * stmt_sequence(void);
-static TreeNode * statement(void);
-static TreeNode * if_stmt(void);
-static TreeNode * repeat_stmt(void);
-static TreeNode * assign_stmt(void);
-static TreeNode * read_stmt(void);
-static TreeNode * write_stmt(void);
-static TreeNode * exp(void);
-static TreeNode * simple_exp(void);
-static TreeNode * term(void);
-static TreeNode * factor(void);
+static NodeId statement(void);
+static NodeId expression(void);
+static NodeId simple_exp(void);
 
+/* syntaxError reports the current token as yyerror
+   does and abandons the parse: like the yacc parser,
+   this one stops at the first error */
 static void syntaxError(char * message)
-{ fprintf(listing,"\n>>> ");
-  fprintf(listing,"Syntax error at line %d: %s",lineno,message);
+{ fprintf(listing,"Syntax error at line %d: %s\n",lineOf(tokenOffset),message);
+  fprintf(listing,"Current token: ");
+  printToken(token,tokenString);
   Error = TRUE;
+  longjmp(failed,1);
 }
 
 static void match(TokenType expected)
 { if (token == expected) token = getToken();
-  else {
-    syntaxError("unexpected token -> ");
-    printToken(token,tokenString);
-    fprintf(listing,"      ");
+  else syntaxError("syntax error");
+}
+
+/* enter and leave bracket a recursive call */
+static void enter(void)
+{ if (++nesting > MAXNESTING) syntaxError("nesting too deep");
+}
+
+static void leave(void)
+{ nesting--;
+}
+
+/* id matches an identifier, returning its name and
+   setting *offset to its offset */
+static char * id(int * offset)
+{ char * name = tokenName;
+  *offset = tokenOffset;
+  match(ID);
+  return name;
+}
+
+static ExpType type_spec(void)
+{ switch (token) {
+    case INT : match(INT); return Integer;
+    case VOID : match(VOID); return Void;
+    default : syntaxError("syntax error");
   }
+  return Void;
 }
 
-TreeNode * stmt_sequence(void)
-{ TreeNode * t = statement();
-  TreeNode * p = t;
-  while ((token!=ENDFILE) && (token!=END) &&
-         (token!=ELSE) && (token!=UNTIL))
-  { TreeNode * q;
+/* var_decl_rest finishes the declaration of the
+   variable name, of type t, whose name is at offset */
+static NodeId var_decl_rest(ExpType t, char * name, int offset)
+{ NodeId d;
+  if (token == LBRACE)
+  { int size;
+    match(LBRACE);
+    size = (token == NUM) ? atoi(tokenString) : 0;
+    match(NUM);
+    match(RBRACE);
     match(SEMI);
-    q = statement();
-    if (q!=NULL) {
-      if (t==NULL) t = p = q;
-      else /* now p cannot be NULL either */
-      { p->sibling = q;
-        p = q;
-      }
-    }
+    d = newStmtNode(ArrVarDeclK);
+    setArraySize(d,size);
   }
-  return t;
+  else
+  { match(SEMI);
+    d = newStmtNode(VarDeclK);
+  }
+  node(d)->attr.name = name;
+  node(d)->decl = t;
+  node(d)->offset = offset;
+  return d;
 }
 
-TreeNode * statement(void)
-{ TreeNode * t = NULL;
-  switch (token) {
-    case IF : t = if_stmt(); break;
-    case REPEAT : t = repeat_stmt(); break;
-    case ID : t = assign_stmt(); break;
-    case READ : t = read_stmt(); break;
-    case WRITE : t = write_stmt(); break;
-    default : syntaxError("unexpected token -> ");
-              printToken(token,tokenString);
-              token = getToken();
-              break;
-  } /* end case */
-  return t;
+static NodeId var_decl(void)
+{ ExpType t = type_spec();
+  int offset;
+  char * name = id(&offset);
+  return var_decl_rest(t,name,offset);
 }
 
-TreeNode * if_stmt(void)
-{ TreeNode * t = newStmtNode(IfK);
-  match(IF);
-  if (t!=NULL) t->child[0] = exp();
-  match(THEN);
-  if (t!=NULL) t->child[1] = stmt_sequence();
-  if (token==ELSE) {
-    match(ELSE);
-    if (t!=NULL) t->child[2] = stmt_sequence();
-  }
-  match(END);
-  return t;
+/* param_rest finishes a parameter of type t */
+static NodeId param_rest(ExpType t)
+{ NodeId p;
+  int offset;
+  char * name = id(&offset);
+  if (token == LBRACE)
+  { match(LBRACE);
+    match(RBRACE);
+    p = newStmtNode(ArrParamK);
+  }
+  else p = newStmtNode(ParamK);
+  node(p)->attr.name = name;
+  node(p)->decl = t;
+  node(p)->offset = offset;
+  return p;
 }
 
-TreeNode * repeat_stmt(void)
-{ TreeNode * t = newStmtNode(RepeatK);
-  match(REPEAT);
-  if (t!=NULL) t->child[0] = stmt_sequence();
-  match(UNTIL);
-  if (t!=NULL) t->child[1] = exp();
+static NodeId params(void)
+{ NodeId t, last;
+  ExpType type;
+  if (token == VOID)
+  { int offset = tokenOffset;
+    match(VOID);
+    if (token == RPAREN)
+    { t = newStmtNode(ParamK);
+      node(t)->attr.name = nullName;
+      node(t)->decl = Void;
+      node(t)->offset = offset;
+      return t;
+    }
+    type = Void;
+  }
+  else type = type_spec();
+  t = last = param_rest(type);
+  while (token == COMMA)
+  { match(COMMA);
+    type = type_spec();
+    node(last)->sibling = param_rest(type);
+    last = node(last)->sibling;
+  }
   return t;
 }
 
-TreeNode * assign_stmt(void)
-{ TreeNode * t = newStmtNode(AssignK);
-  if ((t!=NULL) && (token==ID))
-    t->attr.name = copyString(tokenString);
-  match(ID);
-  match(ASSIGN);
-  if (t!=NULL) t->child[0] = exp();
+static NodeId comp_stmt(void)
+{ NodeId t, decls = NONODE, stmts = NONODE, last = NONODE;
+  int offset = tokenOffset;
+  match(LCURLY);
+  while ((token == INT) || (token == VOID))
+  { NodeId d = var_decl();
+    if (last == NONODE) decls = d;
+    else node(last)->sibling = d;
+    last = d;
+  }
+  last = NONODE;
+  while (token != RCURLY)
+  { NodeId s = statement();
+    if (s == NONODE) continue;
+    if (last == NONODE) stmts = s;
+    else node(last)->sibling = s;
+    last = s;
+  }
+  match(RCURLY);
+  t = newStmtNode(CompK);
+  node(t)->offset = offset;
+  node(t)->child[0] = decls;
+  node(t)->child[1] = stmts;
   return t;
 }
 
-TreeNode * read_stmt(void)
-{ TreeNode * t = newStmtNode(ReadK);
-  match(READ);
-  if ((t!=NULL) && (token==ID))
-    t->attr.name = copyString(tokenString);
-  match(ID);
+static NodeId selection_stmt(void)
+{ NodeId t, test, then, other = NONODE;
+  int offset = tokenOffset;
+  match(IF);
+  match(LPAREN);
+  test = expression();
+  match(RPAREN);
+  then = statement();
+  if (token == ELSE) /* an else goes with the nearest if */
+  { match(ELSE);
+    other = statement();
+  }
+  t = newStmtNode(IfK);
+  node(t)->offset = offset;
+  node(t)->child[0] = test;
+  node(t)->child[1] = then;
+  node(t)->child[2] = other;
   return t;
 }
 
-TreeNode * write_stmt(void)
-{ TreeNode * t = newStmtNode(WriteK);
-  match(WRITE);
-  if (t!=NULL) t->child[0] = exp();
+static NodeId iteration_stmt(void)
+{ NodeId t, test, body;
+  int offset = tokenOffset;
+  match(WHILE);
+  match(LPAREN);
+  test = expression();
+  match(RPAREN);
+  body = statement();
+  t = newStmtNode(WhileK);
+  node(t)->offset = offset;
+  node(t)->child[0] = test;
+  node(t)->child[1] = body;
   return t;
 }
 
-TreeNode * exp(void)
-{ TreeNode * t = simple_exp();
-  if ((token==LT)||(token==EQ)) {
-    TreeNode * p = newExpNode(OpK);
-    if (p!=NULL) {
-      p->child[0] = t;
-      p->attr.op = token;
-      t = p;
-    }
-    match(token);
-    if (t!=NULL)
-      t->child[1] = simple_exp();
-  }
+static NodeId return_stmt(void)
+{ NodeId t, e = NONODE;
+  int offset = tokenOffset;
+  match(RETURN);
+  if (token != SEMI) e = expression();
+  match(SEMI);
+  t = newStmtNode(RetK);
+  node(t)->offset = offset;
+  node(t)->child[0] = e;
   return t;
 }
 
-TreeNode * simple_exp(void)
-{ TreeNode * t = term();
-  while ((token==PLUS)||(token==MINUS))
-  { TreeNode * p = newExpNode(OpK);
-    if (p!=NULL) {
-      p->child[0] = t;
-      p->attr.op = token;
-      t = p;
-      match(token);
-      t->child[1] = term();
-    }
-  }
+static NodeId statement(void)
+{ NodeId t = NONODE;
+  enter();
+  switch (token) {
+    case IF : t = selection_stmt(); break;
+    case WHILE : t = iteration_stmt(); break;
+    case RETURN : t = return_stmt(); break;
+    case LCURLY : t = comp_stmt(); break;
+    case SEMI : match(SEMI); break;
+    case ID :
+    case NUM :
+    case LPAREN :
+      t = expression();
+      match(SEMI);
+      break;
+    default : syntaxError("syntax error");
+  } /* end case */
+  leave();
   return t;
 }
 
-TreeNode * term(void)
-{ TreeNode * t = factor();
-  while ((token==TIMES)||(token==OVER))
-  { TreeNode * p = newExpNode(OpK);
-    if (p!=NULL) {
-      p->child[0] = t;
-      p->attr.op = token;
-      t = p;
-      match(token);
-      p->child[1] = factor();
+/* var_or_call parses an identifier and what
+   follows it, if that makes it an array element or
+   a call; *isVar tells whether it can be assigned */
+static NodeId var_or_call(int * isVar)
+{ NodeId t, e = NONODE;
+  int offset;
+  char * name = id(&offset);
+  *isVar = (token != LPAREN);
+  if (token == LBRACE)
+  { match(LBRACE);
+    e = simple_exp();
+    match(RBRACE);
+    t = newExpNode(ArrIdK);
+  }
+  else if (token == LPAREN)
+  { match(LPAREN);
+    if (token != RPAREN)
+    { NodeId last = e = expression();
+      while (token == COMMA)
+      { match(COMMA);
+        node(last)->sibling = expression();
+        last = node(last)->sibling;
+      }
     }
+    match(RPAREN);
+    t = newExpNode(CallK);
   }
+  else t = newExpNode(IdK);
+  node(t)->attr.name = name;
+  node(t)->offset = offset;
+  node(t)->child[0] = e;
   return t;
 }
 
-TreeNode * factor(void)
-{ TreeNode * t = NULL;
+static NodeId factor(void)
+{ NodeId t = NONODE;
+  int isVar;
   switch (token) {
     case NUM :
       t = newExpNode(ConstK);
-      if ((t!=NULL) && (token==NUM))
-        t->attr.val = atoi(tokenString);
+      node(t)->attr.val = atoi(tokenString);
+      node(t)->offset = tokenOffset;
       match(NUM);
       break;
     case ID :
-      t = newExpNode(IdK);
-      if ((t!=NULL) && (token==ID))
-        t->attr.name = copyString(tokenString);
-      match(ID);
+      t = var_or_call(&isVar);
       break;
     case LPAREN :
       match(LPAREN);
-      t = exp();
+      t = expression();
       match(RPAREN);
       break;
-    default:
-      syntaxError("unexpected token -> ");
-      printToken(token,tokenString);
-      token = getToken();
-      break;
+    default : syntaxError("syntax error");
+  }
+  return t;
+}
+
+/* the binary operators bind in three levels: the
+   comparisons, which do not associate, then the
+   additive and the multiplicative operators, which
+   associate to the left */
+#define RELATIONAL 1
+#define ADDITIVE 2
+#define MULTIPLICATIVE 3
+
+static int precedence(TokenType op)
+{ switch (op) {
+    case LT : case LE : case GT : case GE : case EQ : case NE :
+      return RELATIONAL;
+    case PLUS : case MINUS :
+      return ADDITIVE;
+    case TIMES : case OVER :
+      return MULTIPLICATIVE;
+    default :
+      return 0;
+  }
+}
+
+/* binary parses the operators of level at least min
+   and their right operands after the left operand
+   left, by precedence climbing */
+static NodeId binary(NodeId left, int min)
+{ int prec;
+  while ((prec = precedence(token)) >= min)
+  { TokenType op = token;
+    NodeId right, t;
+    match(op);
+    right = factor();
+    while (precedence(token) > prec)
+      right = binary(right,prec+1);
+    t = newExpNode(OpK);
+    node(t)->child[0] = left;
+    node(t)->child[1] = right;
+    node(t)->attr.op = op;
+    node(t)->offset = node(left)->offset;
+    left = t;
+    if (prec == RELATIONAL) break;
+  }
+  return left;
+}
+
+static NodeId simple_exp(void)
+{ NodeId t;
+  enter();
+  t = binary(factor(),ADDITIVE);
+  leave();
+  return t;
+}
+
+static NodeId expression(void)
+{ NodeId t;
+  enter();
+  if (token == ID)
+  { int isVar;
+    t = var_or_call(&isVar);
+    if (isVar && (token == ASSIGN))
+    { NodeId a, e;
+      match(ASSIGN);
+      e = expression();
+      a = newStmtNode(AssignK);
+      node(a)->attr.name = node(t)->attr.name;
+      node(a)->child[0] = t;
+      node(a)->child[1] = e;
+      node(a)->offset = node(t)->offset;
+      t = a;
     }
+    else t = binary(t,RELATIONAL);
+  }
+  else t = binary(factor(),RELATIONAL);
+  leave();
+  return t;
+}
+
+static NodeId declaration(void)
+{ ExpType type = type_spec();
+  int offset;
+  char * name = id(&offset);
+  NodeId t, p, body;
+  if (token != LPAREN) return var_decl_rest(type,name,offset);
+  match(LPAREN);
+  p = params();
+  match(RPAREN);
+  body = comp_stmt();
+  t = newStmtNode(FunK);
+  node(t)->attr.name = name;
+  node(t)->decl = type;
+  node(t)->offset = offset;
+  node(t)->child[0] = p;
+  node(t)->child[1] = body;
+  return t;
+}
+
+static NodeId declaration_list(void)
+{ NodeId t = NONODE, last = NONODE;
+  do
+  { int start = tokenOffset;
+    NodeId d = declaration();
+    if (last == NONODE) t = d;
+    else node(last)->sibling = d;
+    last = d;
+    addTopDecl(d,start);
+  } while ((token == INT) || (token == VOID));
   return t;
 }
 
 /****************************************/
 /* the primary function of the parser   */
 /****************************************/
-/* Function parse returns the newly 
+/* Function parse returns the newly
  * constructed syntax tree
  */
-TreeNode * parse(void)
-{ TreeNode * t;
-  token = getToken();
-  t = stmt_sequence();
-  if (token!=ENDFILE)
-    syntaxError("Code ends before file\n");
-  return t;
+NodeId parse(void)
+{ if (YaccParse) return yaccParse();
+  nullName = internName("(null)",6);
+  nesting = 0;
+  savedTree = NONODE;
+  if (setjmp(failed) == 0)
+  { token = getToken();
+    savedTree = declaration_list();
+    /* the yacc parser takes the program to end where
+       no declaration starts, and only then finds an
+       error in what follows: the declarations before
+       it are still the tree */
+    if (token != ENDFILE) syntaxError("syntax error");
+  }
+  return savedTree;
 }
@@ -9,8 +9,54 @@
 #define _PARSE_H_
 
 /* Function parse returns the newly 
- * constructed syntax tree
+ * constructed syntax tree, built by the
+ * recursive-descent parser of parse.c or, if
+ * YaccParse is set, by yaccParse. The two build the
+ * same tree and stop at the same first error
  */
-TreeNode * parse(void);
+NodeId parse(void);
+
+/* Function yaccParse returns the syntax tree built
+ * by the LALR parser generated from cminus.y
+ */
+NodeId yaccParse(void);
+
+/* The LALR parser is a push parser: rather than
+ * calling the scanner for each token it needs, it is
+ * handed tokens (see TokenRec in scan.h) as they
+ * become available, one at a time or in batches,
+ * from the scanner or any other source. yaccParse
+ * drives it from getToken; the functions below drive
+ * it directly, as pipelined and incremental parses
+ * do. Only one parse may be in progress at a time
+ */
+typedef struct parseState * ParseState;
+
+typedef enum {ParseMore,ParseDone,ParseError} ParseStatus;
+
+/* Function parseStart begins a push parse; returns
+ * NULL if it runs out of memory. It interns the one
+ * name the grammar needs itself, so when the tokens
+ * come from a scanner thread it must be called
+ * before that thread starts
+ */
+ParseState parseStart(void);
+
+/* Function parsePush hands the n tokens at toks to
+ * the parse ps, in order. Returns ParseMore while
+ * the parse needs more tokens, then ParseDone once
+ * an ENDFILE token completes the program or
+ * ParseError once a syntax error stops it; tokens
+ * pushed after that are ignored. Each token's
+ * lexeme is read from srcText, so its offset and
+ * length must describe a span of it
+ */
+ParseStatus parsePush(ParseState ps, const TokenRec * toks, int n);
+
+/* Function parseFinish ends the parse ps, ending its
+ * input first if no ENDFILE token has been pushed,
+ * and returns the syntax tree; ps is freed
+ */
+NodeId parseFinish(ParseState ps);
 
 #endif
@@ -0,0 +1,145 @@
+/****************************************************/
+/* File: parsebench.c                               */
+/* Scaling benchmark driver for the C-Minus parser: */
+/* times parse() alone, with tracing off (-y with   */
+/* the LALR parser), or with                        */
+/* -p a pipelined parse and its busy/idle times, or */
+/* with -c the parse through the syntax tree cache  */
+/* (-i updating it incrementally),                  */
+/* and the memory the syntax tree takes             */
+/****************************************************/
+
+#include <time.h>
+#include "globals.h"
+#include "util.h"
+#include "walk.h"
+#include "scan.h"
+#include "parse.h"
+#include "pipeparse.h"
+#include "astcache.h"
+
+/* allocate global variables */
+FILE * source;
+FILE * listing;
+FILE * code;
+
+/* allocate and set tracing flags: the benchmark
+   always parses with tracing off */
+int EchoSource = FALSE;
+int TraceScan = FALSE;
+int MapSource = TRUE;
+int PipeParse = FALSE;
+int YaccParse = FALSE;
+int CacheAst = FALSE;
+int IncrementalParse = FALSE;
+int TraceParse = FALSE;
+int TraceAnalyze = FALSE;
+int TraceCode = FALSE;
+
+int Error = FALSE;
+
+/* counted is the number of nodes walked so far */
+static long counted;
+
+static int countNode( WalkFrame * f )
+{ (void) f;
+  counted++;
+  return ALLCHILDREN;
+}
+
+/* countNodes returns the number of nodes in the
+   syntax tree t */
+static long countNodes( NodeId t )
+{ static const WalkProcs procs = {countNode,NULL,NULL};
+  counted = 0;
+  walkTree(t,&procs);
+  return counted;
+}
+
+/* countTokens returns the number of tokens in the
+   source, ENDFILE included, scanning it again */
+static long countTokens( void )
+{ long n = 1;
+  if (!scanRange(0,-1)) return 0;
+  while (getToken() != ENDFILE) n++;
+  endScan();
+  return n;
+}
+
+static void usage( char * pgm )
+{ fprintf(stderr,"usage: %s [-y] [-p] [-c] [-i] <filename>\n",pgm);
+  fprintf(stderr,"  -y  parse with the LALR parser instead of the recursive-descent one\n");
+  fprintf(stderr,"  -p  scan on a thread of its own, pipelined with the parser\n");
+  fprintf(stderr,"  -c  read the tree from <filename>.cmast if it is current, else write it there\n");
+  fprintf(stderr,"  -i  as -c, but update the tree in <filename>.cmast if it is for an earlier version\n");
+  exit(1);
+}
+
+int main( int argc, char * argv[] )
+{ NodeId syntaxTree;
+  struct timespec t0, t1;
+  PipeStats ps;
+  Compilation comp;
+  double secs, walk;
+  long nodes, tokens;
+  CacheStats cs;
+  int i;
+  for (i=1;(i<argc) && (argv[i][0]=='-');i++)
+    if (strcmp(argv[i],"-p") == 0) PipeParse = TRUE;
+    else if (strcmp(argv[i],"-y") == 0) YaccParse = TRUE;
+    else if (strcmp(argv[i],"-c") == 0) CacheAst = TRUE;
+    else if (strcmp(argv[i],"-i") == 0) CacheAst = IncrementalParse = TRUE;
+    else usage(argv[0]);
+  if (i != argc-1) usage(argv[0]);
+  source = fopen(argv[i],"r");
+  if (source==NULL)
+  { fprintf(stderr,"File %s not found\n",argv[i]);
+    exit(1);
+  }
+  listing = stdout;
+  beginCompilation(&comp);
+  clock_gettime(CLOCK_MONOTONIC,&t0);
+  if (CacheAst)
+  { char * astfile = (char *) malloc(strlen(argv[i])+7);
+    strcpy(astfile,argv[i]);
+    strcat(astfile,".cmast");
+    syntaxTree = cachedParse(astfile,&cs);
+    free(astfile);
+  }
+  else
+    syntaxTree = PipeParse ? pipeParse(&ps) : parse();
+  clock_gettime(CLOCK_MONOTONIC,&t1);
+  if (Error)
+  { fprintf(stderr,"%s: could not parse %s\n",argv[0],argv[i]);
+    exit(1);
+  }
+  secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+  if (secs <= 0) secs = 1e-9;
+  clock_gettime(CLOCK_MONOTONIC,&t0);
+  nodes = countNodes(syntaxTree);
+  clock_gettime(CLOCK_MONOTONIC,&t1);
+  walk = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+  fprintf(listing,"%10ld nodes %8.3f s %8.1f ns/node, walked in %6.1f ns/node\n",
+          nodes, secs, secs * 1e9 / nodes, walk * 1e9 / nodes);
+  if (CacheAst)
+    fprintf(listing,"%10s tree %s: %d of %d declarations, %ld bytes parsed\n","",
+            (cs.result == CacheHit) ? "read from the cache" :
+            (cs.result == CacheUpdate) ? "updated in the cache" :
+            "parsed and written to the cache",
+            cs.reparsed, cs.decls, cs.bytes);
+  else if (PipeParse)
+    fprintf(listing,"%10ld tokens  scan %7.3f s busy %7.3f s idle (%ld waits)"
+            "  parse %7.3f s busy %7.3f s idle (%ld waits)\n",
+            ps.tokens, ps.scanBusy, ps.scanIdle, ps.scanWaits,
+            ps.parseBusy, ps.parseIdle, ps.parseWaits);
+  fprintf(listing,"%10ld stmt + %ld exp nodes of %d bytes, %ld strings, %ld KB used of %ld KB reserved\n",
+          comp.stmtNodes, comp.expNodes, (int) sizeof(TreeNode), comp.strings,
+          comp.arena.used / 1024, comp.arena.reserved / 1024);
+  tokens = countTokens();
+  if (tokens > 0)
+    fprintf(listing,"%10ld tokens, %.3f nodes made per token\n",
+            tokens, (double) (comp.stmtNodes + comp.expNodes) / tokens);
+  endCompilation(&comp);
+  fclose(source);
+  return 0;
+}
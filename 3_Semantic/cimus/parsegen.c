@@ -0,0 +1,186 @@
+/****************************************************/
+/* File: parsegen.c                                 */
+/* Synthetic C-Minus source generator for the       */
+/* parser scaling benchmark                         */
+/****************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* the list shapes the generator can produce: one
+   function with n statements, n global declarations,
+   a function with n parameters called with n
+   arguments, n functions of a few statements, or n
+   functions of nested blocks */
+typedef enum {STMTS,DECLS,ARGS,FUNCS,BLOCKS} Shape;
+
+#define SHAPES 5
+
+static const char * shapeName[] = {"stmts","decls","args","funcs","blocks"};
+
+/* DEEPBLOCKS = depth of the blocks nested in every
+   thousandth function of the blocks shape */
+#define DEEPBLOCKS 1000
+
+/* edited is the element given an edit, -1 if none:
+   an extra statement (or declaration, or argument)
+   comes before it, as if typed in there */
+static long edited = -1;
+
+/* name writes prefix followed by i spelled in
+   letters, C-Minus identifiers having no digits */
+static void name( const char * prefix, long i )
+{ char buf[16];
+  int n = 0;
+  do
+  { buf[n++] = 'a' + i % 26;
+    i /= 26;
+  } while (i > 0);
+  fputs(prefix,stdout);
+  while (n > 0) putchar(buf[--n]);
+}
+
+/* genStmt writes the i-th statement of the body of
+   main, cycling through the statement forms */
+static void genStmt( long i )
+{ switch (i % 5)
+  { case 0:
+      printf("  x = x + %ld;\n",i % 1000);
+      break;
+    case 1:
+      printf("  a[x - %ld] = x * 2;\n",i % 10);
+      break;
+    case 2:
+      printf("  if (x < %ld) x = x + 1; else x = x - 1;\n",i % 1000);
+      break;
+    case 3:
+      printf("  while (x > %ld) x = x / 2;\n",i % 1000);
+      break;
+    case 4:
+      printf("  output(x);\n");
+      break;
+  }
+}
+
+static void genStmts( long n )
+{ long i;
+  printf("void main(void)\n{\n  int x;\n  int a[10];\n");
+  for (i=0;i<n;i++)
+  { if (i == edited) printf("  x = x - 1;\n");
+    genStmt(i);
+  }
+  printf("}\n");
+}
+
+static void genDecls( long n )
+{ long i;
+  for (i=0;i<n;i++)
+  { if (i == edited) printf("int edit;\n");
+    if (i % 4 == 3)
+    { printf("int ");
+      name("g",i);
+      printf("[%ld];\n",1 + i % 100);
+    }
+    else
+    { printf("int ");
+      name("g",i);
+      printf(";\n");
+    }
+  }
+  printf("void main(void)\n{\n  output(0);\n}\n");
+}
+
+static void genArgs( long n )
+{ long i;
+  printf("int f(");
+  for (i=0;i<n;i++)
+  { if (i > 0) printf(",\n       ");
+    printf("int ");
+    name("p",i);
+  }
+  printf(")\n{\n  return pa;\n}\n");
+  printf("void main(void)\n{\n  output(f(");
+  for (i=0;i<n;i++)
+  { if (i == edited) printf("0 + ");
+    printf((i > 0) ? ",\n           %ld" : "%ld",i % 1000);
+  }
+  printf("));\n}\n");
+}
+
+/* genFuncs writes n functions of five statements
+   each, cycling through the statement forms, and a
+   main that calls the last */
+static void genFuncs( long n )
+{ long i, j;
+  for (i=0;i<n;i++)
+  { printf("int ");
+    name("f",i);
+    printf("(int x)\n{\n  int a[10];\n");
+    if (i == edited) printf("  x = x - 1;\n");
+    for (j=0;j<5;j++) genStmt(5*i+j);
+    printf("  return x;\n}\n");
+  }
+  printf("void main(void)\n{\n  output(");
+  name("f",n-1);
+  printf("(0));\n}\n");
+}
+
+/* genBlocks writes n functions whose bodies nest
+   blocks 1 to 8 deep, or DEEPBLOCKS deep in every
+   thousandth, each block declaring a variable set
+   from the enclosing block's, and a main that calls
+   the last */
+static void genBlocks( long n )
+{ long i, d, depth;
+  for (i=0;i<n;i++)
+  { depth = (i % 1000 == 999) ? DEEPBLOCKS : 1 + i % 8;
+    printf("int ");
+    name("f",i);
+    printf("(int x)\n{\n");
+    if (i == edited) printf("  x = x - 1;\n");
+    for (d=0;d<depth;d++)
+    { printf("  { int ");
+      name("b",d);
+      printf("; ");
+      name("b",d);
+      printf(" = ");
+      if (d == 0) printf("x");
+      else name("b",d-1);
+      printf(";\n");
+    }
+    printf("  x = ");
+    name("b",depth-1);
+    printf(";\n ");
+    for (d=0;d<depth;d++) printf(" }");
+    printf("\n  return x;\n}\n");
+  }
+  printf("void main(void)\n{\n  output(");
+  name("f",n-1);
+  printf("(0));\n}\n");
+}
+
+int main( int argc, char * argv[] )
+{ long n;
+  int i;
+  if ((argc != 3) && (argc != 4))
+  { fprintf(stderr,"usage: %s stmts|decls|args|funcs|blocks <n> [<edited element>]\n",argv[0]);
+    exit(1);
+  }
+  for (i=0;i<SHAPES;i++)
+    if (strcmp(argv[1],shapeName[i]) == 0) break;
+  if (i == SHAPES)
+  { fprintf(stderr,"%s: unknown shape %s\n",argv[0],argv[1]);
+    exit(1);
+  }
+  n = atol(argv[2]);
+  if (argc == 4) edited = atol(argv[3]);
+  switch ((Shape) i)
+  { case STMTS: genStmts(n); break;
+    case DECLS: genDecls(n); break;
+    case ARGS:  genArgs(n); break;
+    case FUNCS: genFuncs(n); break;
+    case BLOCKS: genBlocks(n); break;
+  }
+  return 0;
+}
@@ -0,0 +1,181 @@
+/****************************************************/
+/* File: pipeparse.c                                */
+/* Pipelined scanning and parsing for the C-Minus   */
+/* compiler                                         */
+/****************************************************/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <time.h>
+#include "globals.h"
+#include "scan.h"
+#include "parse.h"
+#include "pipeparse.h"
+
+/* RINGSIZE = tokens the ring holds (a power of 2);
+   PUBLISH = tokens the scanner writes before making
+   them visible to the parser; BATCH = most tokens
+   the parser pushes at once; SPINS = times a stage
+   polls the other before yielding its processor */
+#define RINGSIZE 4096
+#define PUBLISH 64
+#define BATCH 256
+#define SPINS 100
+
+/* the ring and the state the two stages share; head
+   and tail sit on cache lines of their own so that
+   each stage writes only to its own. The lexemes of
+   the tokens stay in srcText, which the scanner never
+   writes behind the tokens it has handed over */
+typedef struct
+   { TokenRec ring[RINGSIZE];
+     _Alignas(64) atomic_ulong tail; /* next slot the scanner fills */
+     _Alignas(64) atomic_ulong head; /* next slot the parser drains */
+     atomic_int stop;                /* set when the parser is done */
+     double busy, idle;              /* the scanner's times */
+     long waits;                     /* the scanner's waits */
+   } Pipe;
+
+static double now( void )
+{ struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/* makeRoom waits until the ring has a free slot at
+   tail, or the parser stops, returning the head it
+   last saw */
+static unsigned long makeRoom( Pipe * p, unsigned long tail )
+{ unsigned long head = atomic_load_explicit(&p->head,memory_order_acquire);
+  double t0;
+  int spins = 0;
+  if (tail - head < RINGSIZE) return head;
+  p->waits++;
+  t0 = now();
+  while ((tail - head == RINGSIZE) &&
+         !atomic_load_explicit(&p->stop,memory_order_relaxed))
+  { if (++spins > SPINS) sched_yield();
+    head = atomic_load_explicit(&p->head,memory_order_acquire);
+  }
+  p->idle += now() - t0;
+  return head;
+}
+
+/* scanStage is the scanner thread: it fills the ring
+   with tokens from getToken up to the ENDFILE token */
+static void * scanStage( void * arg )
+{ Pipe * p = (Pipe *) arg;
+  unsigned long tail = 0, head = 0, published = 0;
+  double t0 = now();
+  TokenType kind;
+  do
+  { TokenRec * t;
+    kind = getToken();
+    if (tail - head == RINGSIZE)
+    { atomic_store_explicit(&p->tail,tail,memory_order_release);
+      published = tail;
+      head = makeRoom(p,tail);
+      if (tail - head == RINGSIZE) break; /* the parser stopped */
+    }
+    t = &p->ring[tail & (RINGSIZE-1)];
+    t->kind = kind;
+    t->offset = tokenOffset;
+    t->length = tokenLength;
+    t->name = tokenName;
+    tail++;
+    if ((tail - published >= PUBLISH) || (kind == ENDFILE))
+    { atomic_store_explicit(&p->tail,tail,memory_order_release);
+      published = tail;
+      if (atomic_load_explicit(&p->stop,memory_order_relaxed)) break;
+    }
+  } while (kind != ENDFILE);
+  p->busy = now() - t0 - p->idle;
+  return NULL;
+}
+
+/* waitTokens waits until the ring holds a token at
+   head, returning the tail it last saw */
+static unsigned long waitTokens( Pipe * p, unsigned long head, PipeStats * s )
+{ unsigned long tail = atomic_load_explicit(&p->tail,memory_order_acquire);
+  double t0;
+  int spins = 0;
+  if (tail != head) return tail;
+  s->parseWaits++;
+  t0 = now();
+  while (tail == head)
+  { if (++spins > SPINS) sched_yield();
+    tail = atomic_load_explicit(&p->tail,memory_order_acquire);
+  }
+  s->parseIdle += now() - t0;
+  return tail;
+}
+
+/* parseStage drains the ring into the parse ps
+   until the parse is over, returning its status; the
+   tokens are pushed from the ring itself, so their
+   slots are handed back only once they are parsed */
+static ParseStatus parseStage( Pipe * p, ParseState ps, PipeStats * s )
+{ unsigned long head = 0, tail = 0;
+  ParseStatus status = ParseMore;
+  while (status == ParseMore)
+  { unsigned long first;
+    int n;
+    if (head == tail) tail = waitTokens(p,head,s);
+    first = head & (RINGSIZE-1);
+    n = (tail - head < BATCH) ? (int) (tail - head) : BATCH;
+    if (first + n > RINGSIZE) n = (int) (RINGSIZE - first);
+    status = parsePush(ps,&p->ring[first],n);
+    head += n;
+    atomic_store_explicit(&p->head,head,memory_order_release);
+    s->tokens += n;
+  }
+  return status;
+}
+
+/* Function pipeParse returns the syntax tree of the
+ * source, scanning it on a thread of its own
+ */
+NodeId pipeParse( PipeStats * stats )
+{ static Pipe p;
+  PipeStats s;
+  pthread_t scanner;
+  ParseState ps;
+  double t0 = now();
+  NodeId t;
+  memset(&s,0,sizeof(s));
+  if (TraceScan) t = parse();
+  else if ((ps = parseStart()) == NULL) t = NONODE;
+  else
+  { atomic_init(&p.tail,0);
+    atomic_init(&p.head,0);
+    atomic_init(&p.stop,FALSE);
+    p.busy = p.idle = 0;
+    p.waits = 0;
+    if (pthread_create(&scanner,NULL,scanStage,&p) != 0)
+    { /* scan on this thread instead, as parse does */
+      TokenRec tok;
+      do
+      { tok.kind = getToken();
+        tok.offset = tokenOffset;
+        tok.length = tokenLength;
+        tok.name = tokenName;
+        s.tokens++;
+      } while (parsePush(ps,&tok,1) == ParseMore);
+    }
+    else
+    { double t1 = now();
+      parseStage(&p,ps,&s);
+      s.parseBusy = now() - t1 - s.parseIdle;
+      atomic_store_explicit(&p.stop,TRUE,memory_order_relaxed);
+      pthread_join(scanner,NULL);
+      s.scanBusy = p.busy;
+      s.scanIdle = p.idle;
+      s.scanWaits = p.waits;
+    }
+    t = parseFinish(ps);
+  }
+  s.seconds = now() - t0;
+  if (stats != NULL) *stats = s;
+  return t;
+}
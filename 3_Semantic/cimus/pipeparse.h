@@ -0,0 +1,48 @@
+/****************************************************/
+/* File: pipeparse.h                                */
+/* Pipelined scanning and parsing for the C-Minus   */
+/* compiler                                         */
+/****************************************************/
+
+#ifndef _PIPEPARSE_H_
+#define _PIPEPARSE_H_
+
+/* In a pipelined parse the scanner runs on a thread
+ * of its own, ahead of the parser. It hands tokens
+ * over through a single-producer, single-consumer
+ * ring that needs no locks: the scanner only ever
+ * advances the tail, the parser only the head. A
+ * full ring holds the scanner back and an empty one
+ * the parser. The ENDFILE token ends the stream, and
+ * a parser that stops on a syntax error tells the
+ * scanner to stop too
+ */
+
+/* PipeStats describes one pipelined parse. Each
+ * stage is busy while it works and idle while it
+ * waits on the other: the scanner on a full ring,
+ * the parser on an empty one. The pipeline pays off
+ * when both stages are mostly busy; if one is mostly
+ * idle, the other alone sets the pace
+ */
+typedef struct
+   { long tokens;      /* tokens handed over */
+     double seconds;   /* wall-clock time of the parse */
+     double scanBusy;  /* scanner time spent scanning */
+     double scanIdle;  /* scanner time waiting on a full ring */
+     double parseBusy; /* parser time spent parsing */
+     double parseIdle; /* parser time waiting on an empty ring */
+     long scanWaits;   /* times the scanner found the ring full */
+     long parseWaits;  /* times the parser found it empty */
+   } PipeStats;
+
+/* Function pipeParse returns the syntax tree of the
+ * source, as parse does, scanning it on a thread of
+ * its own. It falls back to parse when TraceScan is
+ * set, whose output would otherwise interleave with
+ * the parser's, or when no thread can be started.
+ * If stats is not NULL it is filled in
+ */
+NodeId pipeParse( PipeStats * stats );
+
+#endif
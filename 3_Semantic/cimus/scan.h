@@ -14,9 +14,55 @@
 /* tokenString array stores the lexeme of each token */
 extern char tokenString[MAXTOKENLEN+1];
 
+/* tokenName holds the interned name (see intern.h)
+ * of the most recent token if it is an ID, INT or
+ * VOID, and NULL otherwise; unlike tokenString it is
+ * never truncated. Type names are interned here too
+ * so that the parser never has to intern a name
+ * while a scanner thread may be interning others
+ */
+extern char * tokenName;
+
+/* tokenOffset is the byte offset in srcText (see
+ * source.h) of the lexeme of the most recent token;
+ * its line comes from lineOf in lineidx.h
+ */
+extern int tokenOffset;
+
+/* tokenLength is the length in bytes of the lexeme
+ * of the most recent token, 0 for ENDFILE; unlike
+ * tokenString's it is never truncated
+ */
+extern int tokenLength;
+
+/* TokenRec holds everything the parser needs from
+ * one token, so that tokens can be handed to it (see
+ * parse.h) after the scanner has moved on; the lexeme
+ * itself stays in srcText
+ */
+typedef struct
+   { TokenType kind;
+     int offset;  /* as tokenOffset */
+     int length;  /* as tokenLength */
+     char * name; /* as tokenName */
+   } TokenRec;
+
 /* function getToken returns the 
  * next token in source file
  */
 TokenType getToken(void);
 
+/* Function scanRange makes getToken scan only the
+ * bytes of srcText from offset start up to end (-1
+ * for its end), giving ENDFILE there, as if they
+ * were the whole source; the source is loaded first
+ * if it is not yet. getToken starts by scanning all
+ * of it. Returns FALSE if the source cannot be
+ * loaded. The two bytes at end are set to '\0' while
+ * they are scanned up to; endScan, or the next
+ * scanRange, restores them
+ */
+int scanRange(long start, long end);
+void endScan(void);
+
 #endif
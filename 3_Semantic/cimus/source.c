@@ -0,0 +1,115 @@
+/****************************************************/
+/* File: source.c                                   */
+/* Whole-file source buffer for the C-Minus         */
+/* scanner                                          */
+/****************************************************/
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "globals.h"
+#include "source.h"
+
+/* SENTINELS = number of '\0' bytes after the text */
+#define SENTINELS 2
+
+/* READCHUNK = initial size of the buffer used when
+   the source cannot be mapped */
+#define READCHUNK 65536
+
+char * srcText = NULL;
+long srcLen = 0;
+
+/* mapLen is the size of the mapping behind srcText,
+   or 0 when srcText was malloc'd by readSource */
+static size_t mapLen = 0;
+
+/* readSource reads fp up to end of file into a
+   growing malloc'd buffer */
+static int readSource( FILE * fp )
+{ size_t cap = READCHUNK;
+  size_t len = 0;
+  size_t n;
+  char * buf = (char *) malloc(cap);
+  if (buf == NULL)
+  { fprintf(listing,"Out of memory error reading source\n");
+    return FALSE;
+  }
+  while ((n = fread(buf+len,1,cap-len-SENTINELS,fp)) > 0)
+  { len += n;
+    if (len > MAXSOURCE)
+    { fprintf(listing,"Source too long: more than %ld bytes\n",MAXSOURCE);
+      free(buf);
+      return FALSE;
+    }
+    if (len+SENTINELS == cap)
+    { char * t = (char *) realloc(buf,cap*2);
+      if (t == NULL)
+      { fprintf(listing,"Out of memory error reading source\n");
+        free(buf);
+        return FALSE;
+      }
+      buf = t;
+      cap *= 2;
+    }
+  }
+  memset(buf+len,0,SENTINELS);
+  srcText = buf;
+  srcLen = len;
+  mapLen = 0;
+  return TRUE;
+}
+
+/* Function mapSource loads the file behind fp into
+ * srcText, mapping it into memory when MapSource is
+ * set and fp is a regular file, and reading it into
+ * a buffer otherwise
+ */
+int mapSource( FILE * fp )
+{ struct stat st;
+  size_t page = (size_t) sysconf(_SC_PAGESIZE);
+  size_t len;
+  char * base;
+  int fd = fileno(fp);
+  if (!MapSource || (fstat(fd,&st) < 0) || !S_ISREG(st.st_mode) || (st.st_size == 0))
+    return readSource(fp);
+  if (st.st_size > MAXSOURCE)
+  { fprintf(listing,"Source too long: more than %ld bytes\n",MAXSOURCE);
+    return FALSE;
+  }
+  len = ((size_t) st.st_size + SENTINELS + page - 1) / page * page;
+  /* reserve zeroed memory for the text and its sentinels,
+   * then map the file over the start of it: the bytes
+   * past end of file read as zero whether they fall in
+   * the last page of the file or in the reserved tail.
+   * The mapping is private, so the scanner may write
+   * into it without touching the file
+   */
+  base = (char *) mmap(NULL,len,PROT_READ|PROT_WRITE,
+                       MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+  if (base == MAP_FAILED)
+    return readSource(fp);
+  if (mmap(base,(size_t) st.st_size,PROT_READ|PROT_WRITE,
+           MAP_PRIVATE|MAP_FIXED,fd,0) == MAP_FAILED)
+  { munmap(base,len);
+    return readSource(fp);
+  }
+  madvise(base,len,MADV_SEQUENTIAL);
+  srcText = base;
+  srcLen = (long) st.st_size;
+  mapLen = len;
+  return TRUE;
+}
+
+/* Procedure unmapSource releases srcText */
+void unmapSource( void )
+{ if (srcText == NULL) return;
+  if (mapLen > 0)
+    munmap(srcText,mapLen);
+  else
+    free(srcText);
+  srcText = NULL;
+  srcLen = 0;
+  mapLen = 0;
+}
@@ -0,0 +1,39 @@
+/****************************************************/
+/* File: source.h                                   */
+/* Whole-file source buffer for the C-Minus         */
+/* scanner                                          */
+/****************************************************/
+
+#ifndef _SOURCE_H_
+#define _SOURCE_H_
+
+#include <limits.h>
+
+/* srcText holds the whole source program and srcLen
+ * its length in bytes. The two bytes following the
+ * last character are always '\0', so a scanner can
+ * run to the end of the text without checking srcLen
+ * on every character
+ */
+extern char * srcText;
+extern long srcLen;
+
+/* MAXSOURCE = longest source accepted, so that every
+ * offset into srcText, its end included, fits in the
+ * int offsets of tokens and nodes
+ */
+#define MAXSOURCE ((long) INT_MAX - 1)
+
+/* Function mapSource loads the file behind fp into
+ * srcText, mapping it into memory when MapSource is
+ * set and fp is a regular file, and reading it into
+ * a buffer otherwise (pipes, terminals). Returns
+ * FALSE if the source could not be loaded or is
+ * longer than MAXSOURCE
+ */
+int mapSource( FILE * fp );
+
+/* Procedure unmapSource releases srcText */
+void unmapSource( void );
+
+#endif
@@ -0,0 +1,237 @@
+/****************************************************/
+/* File: symbench.c                                 */
+/* Symbol table benchmark for the C-Minus compiler: */
+/* fills many small scopes, or one huge global      */
+/* scope, and times inserts and lookups and the     */
+/* memory the scopes take; or times lookups from    */
+/* deeply nested scopes, or building the symbol     */
+/* table of a program and checking its types        */
+/****************************************************/
+
+#include <time.h>
+#include <malloc.h>
+#include "globals.h"
+#include "util.h"
+#include "scan.h"
+#include "parse.h"
+#include "symtab.h"
+#include "analyze.h"
+#include "intern.h"
+
+/* allocate global variables */
+FILE * source;
+FILE * listing;
+FILE * code;
+
+/* allocate and set tracing flags: the benchmark
+   never traces */
+int EchoSource = FALSE;
+int TraceScan = FALSE;
+int MapSource = TRUE;
+int PipeParse = FALSE;
+int YaccParse = FALSE;
+int CacheAst = FALSE;
+int IncrementalParse = FALSE;
+int TraceParse = FALSE;
+int TraceAnalyze = FALSE;
+int TraceCode = FALSE;
+
+int Error = FALSE;
+
+/* LOOKUPS = times each symbol is looked up */
+#define LOOKUPS 10
+
+/* GLOBALS = global symbols looked up from the
+   innermost of the nested scopes; ROUNDS = times
+   each is */
+#define GLOBALS 100
+#define ROUNDS 1000
+
+static double now( void )
+{ struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC,&t);
+  return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+/* heapUsed returns the bytes malloc has handed out */
+static long heapUsed( void )
+{ return (long) mallinfo2().uordblks;
+}
+
+/* names returns n interned names with prefix */
+static char ** names( const char * prefix, long n )
+{ char ** v = (char **) malloc(n * sizeof(char *));
+  char buf[32];
+  long i;
+  for (i=0;i<n;i++)
+    v[i] = internName(buf,sprintf(buf,"%s%ld",prefix,i));
+  return v;
+}
+
+static void usage( char * pgm )
+{ fprintf(stderr,"usage: %s scopes|global|nested <n> | build <filename>\n",pgm);
+  fprintf(stderr,"  scopes  n function scopes of 0 to 3 symbols each under the global scope\n");
+  fprintf(stderr,"  global  one global scope of n symbols\n");
+  fprintf(stderr,"  nested  lookups of global symbols from n nested scopes\n");
+  fprintf(stderr,"  build   the symbol table of the program in <filename>, and check its types\n");
+  exit(1);
+}
+
+/* nested opens depth scopes one inside the other,
+   each declaring a variable and hiding the first
+   global, and times looking the globals up from the
+   innermost, searching out through the scopes
+   (st_lookup) and by their bindings (st_bound) */
+static int nested( char * pgm, long depth )
+{ char ** sym = names("v",GLOBALS);
+  char ** local = names("l",depth);
+  Scope global, inner;
+  long i, j, found = 0, lookups = (long) ROUNDS * GLOBALS;
+  double t0, walk, bound;
+  global = sc_push(sc_create(NULL,NULL));
+  for (i=0;i<GLOBALS;i++)
+    st_insert(global,sym[i],NULL,Integer,1,nextLocation(global));
+  for (i=0;i<depth;i++)
+  { inner = sc_push(sc_create(sym[0],NULL));
+    st_insert(inner,local[i],NULL,Integer,1,nextLocation(inner));
+    st_insert(inner,sym[0],NULL,Integer,1,nextLocation(inner));
+  }
+  t0 = now();
+  for (j=0;j<ROUNDS;j++)
+    for (i=0;i<GLOBALS;i++)
+      found += (st_lookup(inner,sym[i])->scope == global);
+  walk = now() - t0;
+  t0 = now();
+  for (j=0;j<ROUNDS;j++)
+    for (i=0;i<GLOBALS;i++)
+      found -= (st_bound(sym[i])->scope == global);
+  bound = now() - t0;
+  for (i=0;i<GLOBALS;i++)
+    if (st_bound(sym[i]) != st_lookup(inner,sym[i])) found++;
+  if ((found != 0) || (st_bound(local[0]) == NULL))
+  { fprintf(stderr,"%s: bindings disagree with the scopes\n",pgm);
+    exit(1);
+  }
+  for (i=0;i<=depth;i++) sc_pop();
+  if (st_bound(sym[1]) != NULL)
+  { fprintf(stderr,"%s: bindings outlive their scopes\n",pgm);
+    exit(1);
+  }
+  fprintf(listing,"%9.1f ns/lookup searching %7.1f ns/lookup bound\n",
+          walk * 1e9 / lookups, bound * 1e9 / lookups);
+  return 0;
+}
+
+/* buildProgram parses the program in file and times
+   buildSymtab and typeCheck on its syntax tree,
+   counting the names each looks up */
+static int buildProgram( char * pgm, char * file )
+{ Compilation comp;
+  NodeId syntaxTree;
+  double t0, secs, check;
+  long heap, nodes, lookups, checks;
+  int scopes;
+  source = fopen(file,"r");
+  if (source == NULL)
+  { fprintf(stderr,"File %s not found\n",file);
+    exit(1);
+  }
+  beginCompilation(&comp);
+  syntaxTree = parse();
+  if (Error)
+  { fprintf(stderr,"%s: could not parse %s\n",pgm,file);
+    exit(1);
+  }
+  nodes = nodeCount();
+  heap = heapUsed();
+  t0 = now();
+  lookups = st_lookups();
+  buildSymtab(syntaxTree);
+  secs = now() - t0;
+  lookups = st_lookups() - lookups;
+  heap = heapUsed() - heap;
+  madeScopes(&scopes);
+  t0 = now();
+  checks = st_lookups();
+  typeCheck(syntaxTree);
+  check = now() - t0;
+  checks = st_lookups() - checks;
+  fprintf(listing,"%9d scopes %9ld nodes %7.3f s %7.1f ns/node %7.1f ns/scope %9ld KB\n",
+          scopes, nodes, secs, secs * 1e9 / nodes, secs * 1e9 / scopes, heap / 1024);
+  fprintf(listing,"%16s %9ld lookups building, %9ld checking types in %7.3f s %7.1f ns/node\n",
+          "", lookups, checks, check, check * 1e9 / nodes);
+  endCompilation(&comp);
+  fclose(source);
+  return 0;
+}
+
+int main( int argc, char * argv[] )
+{ Scope global, * scope;
+  char ** sym, ** miss;
+  long n, i, k, j, found = 0, symbols, lookups = 0;
+  long heap;
+  double t0, build, look;
+  int many = FALSE;
+  if (argc != 3) usage(argv[0]);
+  listing = stdout;
+  if (strcmp(argv[1],"build") == 0) return buildProgram(argv[0],argv[2]);
+  if (strcmp(argv[1],"scopes") == 0) many = TRUE;
+  else if (strcmp(argv[1],"global") == 0) many = FALSE;
+  else if (strcmp(argv[1],"nested") != 0) usage(argv[0]);
+  n = atol(argv[2]);
+  if (n <= 0) usage(argv[0]);
+  if (strcmp(argv[1],"nested") == 0) return nested(argv[0],n);
+  /* intern the names before anything is timed */
+  symbols = many ? 4 : n;
+  sym = names("v",symbols);
+  miss = names("m",symbols);
+  scope = (Scope *) malloc(n * sizeof(Scope));
+  heap = heapUsed();
+  t0 = now();
+  global = sc_push(sc_create(NULL,NULL));
+  if (many)
+  { /* a function whose body declares i % 4
+       variables, as many bodies declare none */
+    for (i=0;i<n;i++)
+    { scope[i] = sc_push(sc_create(sym[0],NULL));
+      for (k=0;k<i%4;k++)
+        st_insert(scope[i],sym[k],NULL,Integer,1,nextLocation(scope[i]));
+      sc_pop();
+    }
+    symbols = n / 4 * 6 + (n % 4) * (n % 4 - 1) / 2;
+  }
+  else
+    for (i=0;i<n;i++)
+      st_insert(global,sym[i],NULL,Integer,1,nextLocation(global));
+  build = now() - t0;
+  heap = heapUsed() - heap;
+  /* look up each symbol where it was declared and a
+     missing name, which searches out to the global
+     scope */
+  t0 = now();
+  for (j=0;j<LOOKUPS;j++)
+    if (many)
+      for (i=0;i<n;i++)
+      { for (k=0;k<i%4;k++)
+          found += (st_lookup(scope[i],sym[k]) != NULL);
+        found += (st_lookup(scope[i],miss[0]) != NULL);
+        lookups += i%4 + 1;
+      }
+    else
+      for (i=0;i<n;i++)
+      { found += (st_lookup(global,sym[i]) != NULL);
+        found += (st_lookup(global,miss[i]) != NULL);
+        lookups += 2;
+      }
+  look = now() - t0;
+  if (found != LOOKUPS * symbols)
+  { fprintf(stderr,"%s: lookups found %ld symbols\n",argv[0],found);
+    exit(1);
+  }
+  /* making a scope counts as an insert */
+  n = many ? n + 1 : 1;
+  fprintf(listing,"%9ld symbols %7.1f ns/insert %7.1f ns/lookup %9ld KB, %7.1f bytes/%s\n",
+          symbols, build * 1e9 / (n + symbols), look * 1e9 / lookups, heap / 1024,
+          (double) heap / (many ? n : symbols), many ? "scope" : "symbol");
+  return 0;
+}
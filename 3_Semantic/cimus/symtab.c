@@ -2,8 +2,9 @@
 /* File: symtab.c                                   */
 /* Symbol table implementation for the TINY compiler*/
 /* (allows only one symbol table)                   */
-/* Symbol table is implemented as a chained         */
-/* hash table                                       */
+/* Each scope is an open-addressing hash table      */
+/* The scopes made and open belong to the           */
+/* compilation in progress (see util.h)             */
 /* Compiler Construction: Principles and Practice   */
 /* Kenneth C. Louden                                */
 /****************************************************/
@@ -11,78 +12,201 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stddef.h>
 #include "symtab.h"
+#include "util.h"
+#include "intern.h"
 
-/* SHIFT is the power of two used as multiplier
-   in hash function  */
-#define SHIFT 4
+/* lookups counts the names looked up */
+static long lookups = 0;
 
-static Scope scopes[MAX_SCOPE];
-static int nScope = 0;
+/* LISTSIZE and LISTSHIFT are the size and shift of
+   the chained table scopes used to have: the listing
+   shows a scope's symbols in the order that table
+   held them, by its hash and newest first, so it
+   does not depend on the size the scope's table
+   grew to or on the hash find uses */
+#define LISTSIZE 211
+#define LISTSHIFT 4
 
-static Scope scopeStack[MAX_SCOPE];
-static int nScopeStack = 0;
-
-static int location[MAX_SCOPE];
-
-/* the hash function */
-static int hash ( char * key )
+/* listHash is the hash of the old chained table */
+static int listHash( char * key )
 { int temp = 0;
   int i = 0;
   while (key[i] != '\0')
-  { temp = ((temp << SHIFT) + key[i]) % SIZE;
+  { temp = ((temp << LISTSHIFT) + key[i]) % LISTSIZE;
     ++i;
   }
   return temp;
 }
 
+/* find returns the slot of scope holding name, or
+   the empty slot where it would go; names are
+   interned (see intern.h), so their hash is already
+   known and they compare by pointer */
+static Bucket * find( Scope scope, char * name )
+{ unsigned int mask = scope->nSlots - 1;
+  unsigned int i = nameHash(name) & mask;
+  while ((scope->slot[i] != NULL) && (scope->slot[i]->name != name))
+    i = (i + 1) & mask;
+  return &scope->slot[i];
+}
+
+/* grow doubles the table of scope */
+static void grow( Scope scope )
+{ Bucket * old = scope->slot;
+  int n = scope->nSlots, i;
+  scope->slot = (Bucket *) symtabAlloc(2*n * sizeof(Bucket));
+  memset(scope->slot, 0, 2*n * sizeof(Bucket));
+  scope->nSlots = 2*n;
+  for (i = 0; i < n; i++)
+    if (old[i] != NULL)
+      *find(scope, old[i]->name) = old[i];
+}
+
+/* A line is kept as its difference d from the line
+   before it, modulo 2^32, zigzag coded (0, -1, 1,
+   -2, ... as 0, 1, 2, 3, ...) and written 7 bits to a byte, low
+   bits first, the top bit of a byte set when more
+   follow */
+
+/* CHUNKHEAD = bytes of a chunk before its deltas */
+#define CHUNKHEAD offsetof(LineChunkRec, delta)
+
+/* firstChunk returns the chunk made with bucket b */
+#define firstChunk(b) ((LineChunk) ((b) + 1))
+
+/* addLine adds lineno to the end of the lines l */
+static void addLine( LineList *l, int lineno )
+{ LineChunk c = l->last;
+  unsigned int d = (unsigned int) lineno - (unsigned int) l->lastLine;
+  unsigned int z = (d << 1) ^ (0u - (d >> 31));
+  unsigned int rest = z >> 7;
+  int n = 1;
+  while (rest != 0) {
+    rest >>= 7;
+    n++;
+  }
+  if (c->used + n > c->size)
+  { int bytes = 2 * (CHUNKHEAD + c->size);
+    if (bytes > LINECHUNK) bytes = LINECHUNK;
+    c->next = (LineChunk) symtabAlloc(bytes);
+    c = l->last = c->next;
+    c->next = NULL;
+    c->size = bytes - CHUNKHEAD;
+    c->used = 0;
+  }
+  while (z >= 0x80)
+  { c->delta[c->used++] = (unsigned char) (z | 0x80);
+    z >>= 7;
+  }
+  c->delta[c->used++] = (unsigned char) z;
+  l->lastLine = lineno;
+}
+
+/* Procedure lineFirst starts c at the first line
+ * of b
+ */
+void lineFirst( LineCursor * c, Bucket b )
+{
+  c->chunk = firstChunk(b);
+  c->i = 0;
+  c->line = 0;
+}
+
+/* Function lineNext sets *lineno to the next line
+ * of c, returning FALSE if there is none
+ */
+int lineNext( LineCursor * c, int * lineno )
+{
+  unsigned int z = 0;
+  int shift = 0;
+  unsigned char byte;
+  if ((c->chunk != NULL) && (c->i == c->chunk->used)) {
+    c->chunk = c->chunk->next;
+    c->i = 0;
+  }
+  if ((c->chunk == NULL) || (c->i == c->chunk->used))
+    return FALSE;
+  do {
+    byte = c->chunk->delta[c->i++];
+    z |= (unsigned int) (byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  c->line = (int) ((unsigned int) c->line + ((z >> 1) ^ (0u - (z & 1))));
+  *lineno = c->line;
+  return TRUE;
+}
+
+/* bind makes b the binding of its name, above the
+   bindings of scopes no deeper than its own: below
+   those of deeper scopes open, if b is a new symbol
+   of an outer one */
+static void bind( Bucket b )
+{ Bucket *top = (Bucket *) nameBinding(b->name);
+  while ((*top != NULL) && ((*top)->scope->nestedLevel > b->scope->nestedLevel))
+    top = &(*top)->shadowed;
+  b->shadowed = *top;
+  *top = b;
+}
+
+/* unbind removes b from the bindings of its name */
+static void unbind( Bucket b )
+{ Bucket *top = (Bucket *) nameBinding(b->name);
+  while (*top != b)
+    top = &(*top)->shadowed;
+  *top = b->shadowed;
+}
+
 /* Procedure st_insert inserts line numbers and
  * memory locations into the symbol table
  * loc = memory location is inserted only the
- * first time, otherwise ignored
+ * first time, otherwise ignored; it returns the
+ * bucket of name in scope
  */
-void st_insert( Scope scope, char *name, TreeNode *t, ExpType type, int lineno, int loc )
+Bucket st_insert( Scope scope, char *name, TreeNode *t, ExpType type, int lineno, int loc )
 {
-  int h = hash(name);
-  Bucket b = st_lookup_excluding_parent(scope, name);
+  Bucket *slot = find(scope, name);
+  Bucket b = *slot;
   
   if (b == NULL) {
-    b = (Bucket) malloc(sizeof(struct BucketListRec));
+    if (4 * (scope->nSymbols + 1) > 3 * scope->nSlots) {
+      grow(scope);
+      slot = find(scope, name);
+    }
+    b = (Bucket) symtabAlloc(sizeof(BucketListRec) + FIRSTLINES);
     b->name = name;
     b->t = t;
     b->type = type;
-    b->lines = (LineList) malloc(sizeof(struct LineListRec));
-    b->lines->lineno = lineno;
+    b->lines.last = firstChunk(b);
+    b->lines.last->next = NULL;
+    b->lines.last->size = FIRSTLINES - CHUNKHEAD;
+    b->lines.last->used = 0;
+    b->lines.lastLine = 0;
+    addLine(&b->lines, lineno);
     b->memloc = loc;
-    b->lines->next = NULL;
-    b->next = scope->bucket[h];
-    scope->bucket[h] = b;
-  }
-  else {
-    LineList l = b->lines;
-    while (l->next != NULL)
-      l = l->next;
-    l->next = (LineList) malloc(sizeof(struct LineListRec));
-    l->next->lineno = lineno;
-    l->next->next = NULL;
+    b->seq = scope->nSymbols++;
+    b->scope = scope;
+    b->decl = NULL;
+    *slot = b;
+    if (scope->bound)
+      bind(b);
   }
+  else
+    addLine(&b->lines, lineno);
+  return b;
 } /* st_insert */
 
-/* Function st_lookup returns the memory 
- * location of a variable or -1 if not found
+/* Function st_lookup returns the innermost bucket
+ * of name in scope or the scopes enclosing it
  */
 Bucket st_lookup( Scope scope, char *name )
 {
+  lookups++;
   if (name == NULL)
     return NULL;
-  int h = hash(name);
   while (scope != NULL) {
-    Bucket b = scope->bucket[h];
-    while ((b != NULL) && (strcmp(name, b->name) != 0))
-    {   
-        fprintf(listing,"test: %s\n",b->name);
-        b = b->next;
-    }
+    Bucket b = *find(scope, name);
     if (b == NULL)
       scope = scope->parent;
     else
@@ -93,72 +217,94 @@ Bucket st_lookup( Scope scope, char *name )
 
 Bucket st_lookup_excluding_parent( Scope scope, char *name )
 {
-  int h = hash(name);
-  Bucket b = scope->bucket[h];
-  while ((b != NULL) && (strcmp(name, b->name) != 0))
-    b = b->next;
+  lookups++;
+  return *find(scope, name);
+}
 
-  return b;
+/* Function st_bound returns the innermost binding
+ * of name in the scopes open
+ */
+Bucket st_bound( char *name )
+{
+  lookups++;
+  if (name == NULL)
+    return NULL;
+  return *(Bucket *) nameBinding(name);
+}
+
+/* Function st_lookups returns the number of names
+ * looked up so far
+ */
+long st_lookups( void )
+{
+  return lookups;
 }
 
 Scope sc_create( char *funcName, TreeNode *t )
 {
-  Scope newScope = (Scope)malloc(sizeof(ScopeListRec));
-  if (newScope == NULL) {
-    fprintf(stderr, "failed to create new scope\n");
-    exit(1);
-  }
+  Scope newScope = (Scope)symtabAlloc(sizeof(ScopeListRec));
 
   newScope->name = funcName;
   newScope->t = t;
-  for (int i = 0; i < SIZE; i++)
-    newScope->bucket[i] = NULL;
+  newScope->slot = newScope->inlineSlot;
+  newScope->nSlots = SCOPESLOTS;
+  newScope->nSymbols = 0;
+  for (int i = 0; i < SCOPESLOTS; i++)
+    newScope->inlineSlot[i] = NULL;
   Scope parent = sc_top();
   if (parent)
     newScope->nestedLevel = sc_top()->nestedLevel + 1;
   else
     newScope->nestedLevel = 0;
   newScope->parent = parent;
-  newScope->index = nScope;
-  scopes[nScope++] = newScope;
+  newScope->location = 0;
+  newScope->bound = FALSE;
+  addScope(newScope);
   newScope->scopeCreated = FALSE;
   return newScope;
 }
 
 Scope sc_top()
 {
-  if (nScopeStack == 0)
-    return NULL;
-  else
-    return scopeStack[nScopeStack - 1];
+  return topScope();
 }
 
 Scope sc_push( Scope scope )
 {
-  return scopeStack[nScopeStack++] = scope;
+  for (int i = 0; i < scope->nSlots; i++)
+    if (scope->slot[i] != NULL)
+      bind(scope->slot[i]);
+  scope->bound = TRUE;
+  pushScope(scope);
+  return scope;
 }
 
 Scope sc_pop()
 {
-  return scopeStack[--nScopeStack];
+  Scope scope = popScope();
+  for (int i = 0; i < scope->nSlots; i++)
+    if (scope->slot[i] != NULL)
+      unbind(scope->slot[i]);
+  scope->bound = FALSE;
+  return scope;
 }
 
 int nextLocation( Scope scope )
 {
-  return location[scope->index]++;
+  return scope->location++;
 }
 
 void printBucket(Bucket b)
 {
-  LineList l = b->lines;
+  LineCursor l;
+  int lineno;
 
   printf("name: %s\n", b->name);
   printf("type: %s\n", printType(b->type));
   printf("lines: ");
-  while (l) {
-    printf("%d ", l->lineno);
-    l = l->next;
-  }
+  lineFirst(&l, b);
+  while (lineNext(&l, &lineno))
+    printf("%d ", lineno);
   printf("\n");
   printf("memloc: %d\n", b->memloc);
 }
@@ -177,84 +323,120 @@ char *printType(ExpType type)
   }
 }
 
-static void printGlobalSymbol(FILE *listing)
+/* listOrder orders symbols for the listing */
+static int listOrder( const void *p, const void *q )
 {
-  Scope globalScope;
-  for (int i = 0; i < nScope; i++) {
-    if (scopes[i]->name == NULL) {
-      globalScope = scopes[i];
-      break;
-    }
+  Bucket a = *(const Bucket *) p, b = *(const Bucket *) q;
+  int ha = listHash(a->name), hb = listHash(b->name);
+  if (ha != hb)
+    return (ha < hb) ? -1 : 1;
+  return b->seq - a->seq;
+}
+
+/* listed returns the symbols of scope in the order
+   the listing shows them, in an array to be freed */
+static Bucket *listed( Scope scope )
+{
+  Bucket *list = (Bucket *) malloc((scope->nSymbols + 1) * sizeof(Bucket));
+  int n = 0;
+  if (list == NULL) {
+    fprintf(stderr, "failed to list scope\n");
+    exit(1);
   }
-  for (int i = 0; i < SIZE; i++) {
-    Bucket curBucket = globalScope->bucket[i];
-    while (curBucket) {
-      TreeNode *t = curBucket->t;
-      LineList l = curBucket->lines;
-      if (t->nodekind == StmtK) {
-        fprintf(listing, "%-14s", t->attr.name);
-        if (t->kind.stmt == FunK)
-          fprintf(listing, "%-15s", "Function");
-        else
-          fprintf(listing, "%-15s", printType(t->type));
-        fprintf(listing, "%-12s", "global");
-        fprintf(listing, "%-9d", curBucket->memloc);
-        while (l != NULL)
-        { fprintf(listing,"%4d ",l->lineno);
-          l = l->next;
-        }
-        fprintf(listing, "\n");
-      }
-      curBucket = curBucket->next;
+  for (int i = 0; i < scope->nSlots; i++)
+    if (scope->slot[i] != NULL)
+      list[n++] = scope->slot[i];
+  qsort(list, n, sizeof(Bucket), listOrder);
+  return list;
+}
+
+/* findGlobal returns the global scope, the one
+   made without a name, or NULL if none was made */
+static Scope findGlobal(void)
+{
+  int nScope;
+  Scope *scopes = madeScopes(&nScope);
+  for (int i = 0; i < nScope; i++)
+    if (scopes[i]->name == NULL)
+      return scopes[i];
+  return NULL;
+}
+
+static void printGlobalSymbol(FILE *listing)
+{
+  Scope globalScope = findGlobal();
+  if (globalScope == NULL)
+    return;
+  Bucket *list = listed(globalScope);
+  for (int i = 0; i < globalScope->nSymbols; i++) {
+    Bucket curBucket = list[i];
+    TreeNode *t = curBucket->t;
+    LineCursor l;
+    int lineno;
+    if (t->nodekind == StmtK) {
+      fprintf(listing, "%-14s", t->attr.name);
+      if (t->kind.stmt == FunK)
+        fprintf(listing, "%-15s", "Function");
+      else
+        fprintf(listing, "%-15s", printType(t->type));
+      fprintf(listing, "%-12s", "global");
+      fprintf(listing, "%-9d", curBucket->memloc);
+      lineFirst(&l, curBucket);
+      while (lineNext(&l, &lineno))
+        fprintf(listing,"%4d ",lineno);
+      fprintf(listing, "\n");
     }
   }
+  free(list);
 }
 
 static void printLocalSymbol(FILE *listing, Scope curScope)
 {
-  for (int i = 0; i < SIZE; i++) {
-    Bucket curBucket = curScope->bucket[i];
-    while (curBucket) {
-      TreeNode *t = curBucket->t;
-	LineList l = curBucket->lines;
-      if ((t->nodekind == StmtK && t->kind.stmt != FunK) || t->nodekind == ParamK) {
-        fprintf(listing, "%-14s", t->attr.name);
-        fprintf(listing, "%-15s", printType(t->type));
-        fprintf(listing, "%-12s", curScope->name);
+  Bucket *list = listed(curScope);
+  for (int i = 0; i < curScope->nSymbols; i++) {
+    Bucket curBucket = list[i];
+    TreeNode *t = curBucket->t;
+    LineCursor l;
+    int lineno;
+    if ((t->nodekind == StmtK && t->kind.stmt != FunK) || t->nodekind == ParamK) {
+      fprintf(listing, "%-14s", t->attr.name);
+      fprintf(listing, "%-15s", printType(t->type));
+      fprintf(listing, "%-12s", curScope->name);
 	fprintf(listing, "%-9d", curBucket->memloc);
-	while (l != NULL)
-        { fprintf(listing,"%4d ",l->lineno);
-          l = l->next;
-        }
+	lineFirst(&l, curBucket);
+	while (lineNext(&l, &lineno))
+	  fprintf(listing,"%4d ",lineno);
 	fprintf(listing, "\n");
-      }
-      curBucket = curBucket->next;
     }
   }
+  free(list);
 }
 
 static void printFunctionDeclaration(FILE *listing)
 {
+  int nScope;
+  Scope *scopes = madeScopes(&nScope);
   for (int i = 0; i < nScope; i++) {
     Scope tmpScope = scopes[i];
     TreeNode *t = tmpScope->t;
-    TreeNode *param;
+    NodeId param;
     if (t != NULL)
       param = t->child[0];
     else
-      param = NULL;
+      param = NONODE;
     if (tmpScope->parent == NULL)
       continue;
     if (tmpScope->parent->name != NULL)
       continue;
     fprintf(listing, "%-15sglobal\t   %-14s", tmpScope->name, printType(t->type));
-    if (param == NULL)
+    if (param == NONODE)
       fprintf(listing, "\t\t%-19s\n", "Void");
     else {
 	fprintf(listing, "\n");
       while(param) {
-        fprintf(listing, "\t\t\t\t\t %-15s%s\n", param->attr.name, printType(param->type));
-        param = param->sibling;
+        TreeNode *p = node(param);
+        fprintf(listing, "\t\t\t\t\t %-15s%s\n", p->attr.name, printType(p->type));
+        param = p->sibling;
       }
     }
   }
@@ -262,46 +444,40 @@ static void printFunctionDeclaration(FILE *listing)
 
 static void printGlobalDeclarations(FILE *listing)
 {
-  Scope globalScope;
-  for (int i = 0; i < nScope; i++) {
-    if (scopes[i]->name == NULL) {
-      globalScope = scopes[i];
-      break;
-    }
-  }
-  for (int i = 0; i < SIZE; i++) {
-    Bucket curBucket = globalScope->bucket[i];
-    while (curBucket) {
-      TreeNode *t = curBucket->t;
-      if (t->nodekind == StmtK) {
-        fprintf(listing, "%-15s", t->attr.name);
-        if (t->kind.stmt == FunK)
-          fprintf(listing, "%-11s", "Function");
-        else
-          fprintf(listing, "%-11s", "Variable");
-        fprintf(listing, "%s\n", printType(t->type));
-      }
-      curBucket = curBucket->next;
+  Scope globalScope = findGlobal();
+  if (globalScope == NULL)
+    return;
+  Bucket *list = listed(globalScope);
+  for (int i = 0; i < globalScope->nSymbols; i++) {
+    Bucket curBucket = list[i];
+    TreeNode *t = curBucket->t;
+    if (t->nodekind == StmtK) {
+      fprintf(listing, "%-15s", t->attr.name);
+      if (t->kind.stmt == FunK)
+        fprintf(listing, "%-11s", "Function");
+      else
+        fprintf(listing, "%-11s", "Variable");
+      fprintf(listing, "%s\n", printType(t->type));
     }
   }
+  free(list);
   fprintf(listing, "\n");
 }
 
 static void printScopeInfo(FILE *listing, Scope curScope)
 {
-  for (int i = 0; i < SIZE; i++) {
-    Bucket curBucket = curScope->bucket[i];
-    while (curBucket) {
-      TreeNode *t = curBucket->t;
-      if ((t->nodekind == StmtK && t->kind.stmt != FunK) || t->nodekind == ParamK) {
-        fprintf(listing, "%-17s", curScope->name);
-        fprintf(listing, "%-15d", curScope->nestedLevel);  
-        fprintf(listing, "%-14s", t->attr.name);
-        fprintf(listing, "%s\n", printType(t->type));
-      }
-      curBucket = curBucket->next;
+  Bucket *list = listed(curScope);
+  for (int i = 0; i < curScope->nSymbols; i++) {
+    Bucket curBucket = list[i];
+    TreeNode *t = curBucket->t;
+    if ((t->nodekind == StmtK && t->kind.stmt != FunK) || t->nodekind == ParamK) {
+      fprintf(listing, "%-17s", curScope->name);
+      fprintf(listing, "%-15d", curScope->nestedLevel);  
+      fprintf(listing, "%-14s", t->attr.name);
+      fprintf(listing, "%s\n", printType(t->type));
     }
   }
+  free(list);
 }
 
 /* Procedure printSymTab prints a formatted
@@ -310,7 +486,8 @@ static void printScopeInfo(FILE *listing, Scope curScope)
  */
 void printSymTab(FILE *listing)
 {
-  int i;
+  int i, nScope;
+  Scope *scopes = madeScopes(&nScope);
   fprintf(listing, "\n\n< Symbol Table >\n");
   fprintf(listing, "Variable Name Variable Type  Scope Name  Location   Line Numbers\n");
   fprintf(listing, "------------- -------------  ----------  --------   ------------\n");
@@ -11,57 +11,136 @@
 #ifndef _SYMTAB_H_
 #define _SYMTAB_H_
 
-#define MAX_SCOPE 500
-#define SIZE 211
+/* SCOPESLOTS = slots of the table a scope starts
+ * with, held in the scope itself (a power of 2);
+ * the table doubles whenever it would be more than
+ * three quarters full
+ */
+#define SCOPESLOTS 8
 
 /* the list of line numbers of the source 
- * code in which a variable is referenced
+ * code in which a variable is referenced, kept
+ * as the differences between successive lines,
+ * each in as few bytes as it takes (see
+ * symtab.c), in chunks that double in size up to
+ * LINECHUNK bytes: references are mostly entered
+ * in order, so most take a single byte. The first
+ * chunk, of FIRSTLINES bytes, is made with the
+ * bucket and follows it; lines are added to the
+ * last. Both sizes include the chunk's header
  */
-typedef struct LineListRec
-   { int lineno;
-     struct LineListRec * next;
-   } LineListRec, *LineList;
+#define FIRSTLINES 24
+#define LINECHUNK 256
+
+typedef struct LineChunkRec
+   { struct LineChunkRec * next;
+     unsigned short size;    /* bytes of delta */
+     unsigned short used;    /* of them filled */
+     unsigned char delta[];
+   } LineChunkRec, *LineChunk;
 
-/* The record in the bucket lists for
+typedef struct
+   { LineChunk last;       /* the chunk lines are added to */
+     int lastLine;         /* the line added last */
+   } LineList;
+
+/* The record in the scope tables for
  * each variable, including name,
  * assigned memory location, and
  * the list of line numbers in which
- * it appears in the source code
+ * it appears in the source code.
+ * Scopes, buckets and lines are taken
+ * from the compilation in progress (see
+ * symtabAlloc in util.h) and released with it
  */
 typedef struct BucketListRec
 {
   char *name;
   TreeNode *t;
   ExpType type;
-  LineList lines;
   int memloc;
-  struct BucketListRec *next;
+  int seq; /* symbols entered in its scope before it */
+  LineList lines;
+  struct ScopeListRec *scope;      /* the scope it is in */
+  struct BucketListRec *shadowed;  /* the binding of name it hides */
+  struct BucketListRec *decl;      /* the declaration it stands for */
 } BucketListRec, *Bucket;
 
+/* LineCursor reads the lines of a bucket in the
+ * order they were entered: lineFirst starts it and
+ * lineNext sets *lineno to the next line, returning
+ * FALSE once there are no more
+ */
+typedef struct
+   { LineChunk chunk;
+     int i;                /* next byte of chunk */
+     int line;
+   } LineCursor;
+
+void lineFirst( LineCursor * c, Bucket b );
+int lineNext( LineCursor * c, int * lineno );
+
+/* A scope's symbols are kept in an open-addressing
+ * hash table, probed linearly from the hash of the
+ * interned name. A small scope's table is the
+ * slots inline in the scope, so making one costs a
+ * single allocation.
+ *
+ * Besides, each interned name heads a stack of its
+ * bindings in the scopes open, innermost first,
+ * linked through shadowed (LeBlanc and Cook's
+ * scheme): sc_push binds the symbols of the scope,
+ * st_insert a new one of an open scope, and sc_pop
+ * unbinds them, so the innermost binding of a name
+ * is found without searching the enclosing scopes
+ */
 typedef struct ScopeListRec
 {
   char *name;
   TreeNode *t;
-  Bucket bucket[SIZE];
+  Bucket *slot;    /* the table: inlineSlot, or symtabAlloc'd once grown */
+  int nSlots;      /* a power of 2 */
+  int nSymbols;
+  Bucket inlineSlot[SCOPESLOTS];
   int nestedLevel;
   struct ScopeListRec *parent;
-  int index;
+  int location;    /* the next memory location in it */
+  int bound;       /* its symbols are bound: it is open */
   int scopeCreated;
 } ScopeListRec, *Scope;
 
 /* Procedure st_insert inserts line numbers and
  * memory locations into the symbol table
  * loc = memory location is inserted only the
- * first time, otherwise ignored
+ * first time, otherwise ignored; it returns the
+ * bucket of name in scope. A name used in a scope
+ * without being declared there gets a bucket of
+ * its own too, whose decl the caller sets to the
+ * declaration the use resolved to, or to the bucket
+ * itself if the name is undeclared
  */
-void st_insert( Scope scope, char *name, TreeNode *t, ExpType type, int lineno, int loc );
+Bucket st_insert( Scope scope, char *name, TreeNode *t, ExpType type, int lineno, int loc );
 
-/* Function st_lookup returns the memory 
- * location of a variable or -1 if not found
+/* Function st_lookup returns the innermost bucket
+ * of name in scope or the scopes enclosing it, or
+ * NULL if there is none; st_lookup_excluding_parent
+ * looks in scope alone
  */
 Bucket st_lookup( Scope scope, char *name );
 Bucket st_lookup_excluding_parent( Scope scope, char *name );
 
+/* Function st_bound returns the innermost binding
+ * of name in the scopes open, or NULL if there is
+ * none: st_lookup(sc_top(), name) in a single
+ * access, whatever the depth of nesting
+ */
+Bucket st_bound( char *name );
+
+/* Function st_lookups returns the number of names
+ * looked up so far, by any of the above
+ */
+long st_lookups( void );
+
 Scope sc_create( char *funcName, TreeNode *t );
 Scope sc_top();
 Scope sc_push( Scope scope );
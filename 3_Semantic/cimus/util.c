@@ -6,13 +6,24 @@
 /* Kenneth C. Louden                                */
 /****************************************************/
 
+#include <sys/mman.h>
 #include "globals.h"
 #include "util.h"
+#include "walk.h"
+#include "scan.h"
+#include "lineidx.h"
 
 /* Procedure printToken prints a token 
  * and its lexeme to the listing file
  */
 void printToken( TokenType token, const char* tokenString )
+{ printTokenSpan(token,tokenString,(int) strlen(tokenString));
+}
+
+/* Procedure printTokenSpan prints a token and
+ * the len characters of its lexeme at s
+ */
+void printTokenSpan( TokenType token, const char * s, int len )
 { switch (token)
   { case IF:
     case ELSE:
@@ -21,7 +32,7 @@ void printToken( TokenType token, const char* tokenString )
     case VOID:
     case WHILE:
       fprintf(listing,
-         "reserved word: %s\n",tokenString);
+         "reserved word: %.*s\n",len,s);
       break;
     case ASSIGN: fprintf(listing,"=\n"); break;
     case EQ: fprintf(listing,"==\n"); break;
@@ -45,81 +56,350 @@ void printToken( TokenType token, const char* tokenString )
     case ENDFILE: fprintf(listing,"EOF\n"); break;
     case NUM:
       fprintf(listing,
-          "NUM, val= %s\n",tokenString);
+          "NUM, val= %.*s\n",len,s);
       break;
     case ID:
       fprintf(listing,
-          "ID, name= %s\n",tokenString);
+          "ID, name= %.*s\n",len,s);
       break;
     case ERROR:
       fprintf(listing,
-          "ERROR: %s\n",tokenString);
+          "ERROR: %.*s\n",len,s);
       break;
     default: /* should never happen */
       fprintf(listing,"Unknown token: %d\n",token);
   }
 }
 
+/* the compilation in progress, or one lasting as
+   long as the compiler */
+static Compilation lasting;
+static Compilation * current = &lasting;
+
+/* nodeChunks is the node array of the compilation
+ * in progress
+ */
+TreeNode ** nodeChunks = NULL;
+
+/* Procedure beginCompilation empties c and makes
+ * it the compilation new nodes belong to
+ */
+void beginCompilation( Compilation * c )
+{ memset(c,0,sizeof(Compilation));
+  current = c;
+  nodeChunks = NULL;
+}
+
+/* Procedure endCompilation releases the syntax tree
+ * of c
+ */
+void endCompilation( Compilation * c )
+{ arenaRelease(&c->arena);
+  arenaRelease(&c->symtab);
+  free(c->chunks);
+  free(c->sizes);
+  free(c->decls);
+  free(c->scopes);
+  free(c->symbols);
+  free(c->made);
+  free(c->open);
+  if (c->map != NULL) munmap(c->map,c->mapLen);
+  c->map = NULL;
+  c->mapLen = 0;
+  c->chunks = NULL;
+  c->sizes = NULL;
+  c->decls = NULL;
+  c->scopes = NULL;
+  c->symbols = NULL;
+  c->made = c->open = NULL;
+  c->nChunks = c->maxChunks = c->nSizes = c->maxSizes = 0;
+  c->nDecls = c->maxDecls = 0;
+  c->maxScopes = c->maxSymbols = 0;
+  c->nMade = c->maxMade = c->nOpen = c->maxOpen = 0;
+  if (current == c)
+  { current = &lasting;
+    nodeChunks = lasting.chunks;
+  }
+}
+
+static void outOfMemory( void )
+{ fprintf(listing,"Out of memory error at line %d\n",lineOf(tokenOffset));
+  exit(1);
+}
+
+/* newNode returns a new node of zeroes, adding a
+   chunk to the node array when the last is full;
+   the first chunk begins with the reserved node 0 */
+static NodeId newNode( void )
+{ Compilation * c = current;
+  if ((c->nodes & (NODECHUNK-1)) == 0)
+  { TreeNode * chunk;
+    if (c->nChunks == c->maxChunks)
+    { int max = c->maxChunks ? 2*c->maxChunks : 16;
+      TreeNode ** p = (TreeNode **) realloc(c->chunks,max*sizeof(TreeNode *));
+      if (p == NULL) outOfMemory();
+      c->chunks = p;
+      c->maxChunks = max;
+    }
+    chunk = (TreeNode *) arenaAlloc(&c->arena,NODECHUNK*sizeof(TreeNode));
+    if (chunk == NULL) outOfMemory();
+    memset(chunk,0,NODECHUNK*sizeof(TreeNode));
+    c->chunks[c->nChunks++] = chunk;
+    nodeChunks = c->chunks;
+    if (c->nodes == 0) c->nodes = 1;
+  }
+  return c->nodes++;
+}
+
 /* Function newStmtNode creates a new statement
  * node for syntax tree construction
  */
-TreeNode * newStmtNode(StmtKind kind)
-{ TreeNode * t = (TreeNode *) malloc(sizeof(TreeNode));
-  int i;
-  if (t==NULL)
-    fprintf(listing,"Out of memory error at line %d\n",lineno);
-  else {
-    for (i=0;i<MAXCHILDREN;i++) t->child[i] = NULL;
-    t->sibling = NULL;
-    t->nodekind = StmtK;
-    t->kind.stmt = kind;
-    t->lineno = lineno;
-  }
-  return t;
+NodeId newStmtNode(StmtKind kind)
+{ NodeId n = newNode();
+  TreeNode * t = node(n);
+  t->nodekind = StmtK;
+  t->kind.stmt = kind;
+  t->offset = -1;
+  current->stmtNodes++;
+  return n;
 }
 
 /* Function newExpNode creates a new expression 
  * node for syntax tree construction
  */
-TreeNode * newExpNode(ExpKind kind)
-{ TreeNode * t = (TreeNode *) malloc(sizeof(TreeNode));
+NodeId newExpNode(ExpKind kind)
+{ NodeId n = newNode();
+  TreeNode * t = node(n);
+  t->nodekind = ExpK;
+  t->kind.exp = kind;
+  t->offset = -1;
+  t->type = Void;
+  current->expNodes++;
+  return n;
+}
+
+/* Function nodeCount returns the number of nodes
+ * made in the compilation in progress
+ */
+NodeId nodeCount( void )
+{ return current->nodes;
+}
+
+/* Procedure adoptNodes makes the n nodes at nodes
+ * the node array of the compilation in progress:
+ * its chunks are cut from the array in place
+ */
+void adoptNodes( TreeNode * nodes, NodeId n, long stmtNodes, long expNodes,
+                 void * map, size_t mapLen )
+{ Compilation * c = current;
+  int chunks = (n + NODECHUNK-1) >> NODESHIFT;
   int i;
-  if (t==NULL)
-    fprintf(listing,"Out of memory error at line %d\n",lineno);
-  else {
-    for (i=0;i<MAXCHILDREN;i++) t->child[i] = NULL;
-    t->sibling = NULL;
-    t->nodekind = ExpK;
-    t->kind.exp = kind;
-    t->lineno = lineno;
-    t->type = Void;
+  c->chunks = (TreeNode **) malloc((chunks+16)*sizeof(TreeNode *));
+  if (c->chunks == NULL) outOfMemory();
+  for (i=0;i<chunks;i++)
+    c->chunks[i] = nodes + ((NodeId) i << NODESHIFT);
+  c->nChunks = chunks;
+  c->maxChunks = chunks+16;
+  c->nodes = n;
+  c->stmtNodes = stmtNodes;
+  c->expNodes = expNodes;
+  c->map = map;
+  c->mapLen = mapLen;
+  nodeChunks = c->chunks;
+}
+
+/* Function arraySize returns the size recorded for
+ * the array declaration n, found by binary search
+ */
+int arraySize( NodeId n )
+{ int lo = 0, hi = current->nSizes;
+  while (lo < hi)
+  { int mid = (lo + hi) / 2;
+    if (current->sizes[mid].node < n) lo = mid+1;
+    else hi = mid;
   }
-  return t;
+  if ((lo < current->nSizes) && (current->sizes[lo].node == n))
+    return current->sizes[lo].size;
+  return 0;
+}
+
+/* Procedure setArraySize records the size of the
+ * array declaration n
+ */
+void setArraySize( NodeId n, int size )
+{ Compilation * c = current;
+  if (c->nSizes == c->maxSizes)
+  { int max = c->maxSizes ? 2*c->maxSizes : 64;
+    ArraySize * p = (ArraySize *) realloc(c->sizes,max*sizeof(ArraySize));
+    if (p == NULL) outOfMemory();
+    c->sizes = p;
+    c->maxSizes = max;
+  }
+  c->sizes[c->nSizes].node = n;
+  c->sizes[c->nSizes].size = size;
+  c->nSizes++;
+}
+
+/* Procedure addTopDecl adds the declaration n to
+ * the table of top-level declarations
+ */
+void addTopDecl( NodeId n, int start )
+{ Compilation * c = current;
+  if (c->nDecls == c->maxDecls)
+  { int max = c->maxDecls ? 2*c->maxDecls : 64;
+    TopDecl * p = (TopDecl *) realloc(c->decls,max*sizeof(TopDecl));
+    if (p == NULL) outOfMemory();
+    c->decls = p;
+    c->maxDecls = max;
+  }
+  c->decls[c->nDecls].node = n;
+  c->decls[c->nDecls].start = start;
+  c->nDecls++;
+}
+
+/* Function topDecls returns the table of top-level
+ * declarations
+ */
+TopDecl * topDecls( int * n )
+{ *n = current->nDecls;
+  return current->decls;
+}
+
+/* Procedure replaceTopDecls replaces the table of
+ * top-level declarations
+ */
+void replaceTopDecls( TopDecl * decls, int n )
+{ free(current->decls);
+  current->decls = decls;
+  current->nDecls = current->maxDecls = n;
 }
 
-/* Function copyString allocates and makes a new
- * copy of an existing string
+/* Function nodeScope returns the scope recorded for
+ * node n
+ */
+struct ScopeListRec * nodeScope( NodeId n )
+{ return (n < current->maxScopes) ? current->scopes[n] : NULL;
+}
+
+/* Procedure setNodeScope records the scope of node
+ * n, growing the side table to cover every node
+ */
+void setNodeScope( NodeId n, struct ScopeListRec * s )
+{ Compilation * c = current;
+  if (n >= c->maxScopes)
+  { NodeId max = (c->nodes > n) ? c->nodes : n+1;
+    struct ScopeListRec ** p = (struct ScopeListRec **)
+      realloc(c->scopes,max*sizeof(struct ScopeListRec *));
+    if (p == NULL) outOfMemory();
+    memset(p+c->maxScopes,0,(max-c->maxScopes)*sizeof(struct ScopeListRec *));
+    c->scopes = p;
+    c->maxScopes = max;
+  }
+  c->scopes[n] = s;
+}
+
+/* Function nodeSymbol returns the symbol recorded
+ * for node n
+ */
+struct BucketListRec * nodeSymbol( NodeId n )
+{ return (n < current->maxSymbols) ? current->symbols[n] : NULL;
+}
+
+/* Procedure setNodeSymbol records the symbol of
+ * node n, growing the side table to cover every
+ * node
+ */
+void setNodeSymbol( NodeId n, struct BucketListRec * b )
+{ Compilation * c = current;
+  if (n >= c->maxSymbols)
+  { NodeId max = (c->nodes > n) ? c->nodes : n+1;
+    struct BucketListRec ** p = (struct BucketListRec **)
+      realloc(c->symbols,max*sizeof(struct BucketListRec *));
+    if (p == NULL) outOfMemory();
+    memset(p+c->maxSymbols,0,(max-c->maxSymbols)*sizeof(struct BucketListRec *));
+    c->symbols = p;
+    c->maxSymbols = max;
+  }
+  c->symbols[n] = b;
+}
+
+/* growScopes makes room for one more scope in the
+   list *v of *n scopes, of room for *max */
+static void growScopes( struct ScopeListRec *** v, int n, int * max )
+{ if (n == *max)
+  { int m = *max ? 2 * *max : 64;
+    struct ScopeListRec ** p = (struct ScopeListRec **)
+      realloc(*v,m*sizeof(struct ScopeListRec *));
+    if (p == NULL) outOfMemory();
+    *v = p;
+    *max = m;
+  }
+}
+
+/* Procedure addScope adds the scope s to the list
+ * of scopes made
+ */
+void addScope( struct ScopeListRec * s )
+{ Compilation * c = current;
+  growScopes(&c->made,c->nMade,&c->maxMade);
+  c->made[c->nMade++] = s;
+}
+
+/* Function madeScopes returns the list of scopes
+ * made
+ */
+struct ScopeListRec ** madeScopes( int * n )
+{ *n = current->nMade;
+  return current->made;
+}
+
+/* Procedure pushScope opens the scope s */
+void pushScope( struct ScopeListRec * s )
+{ Compilation * c = current;
+  growScopes(&c->open,c->nOpen,&c->maxOpen);
+  c->open[c->nOpen++] = s;
+}
+
+/* Function popScope closes the innermost scope
+ * open and returns it
+ */
+struct ScopeListRec * popScope( void )
+{ return current->open[--current->nOpen];
+}
+
+/* Function topScope returns the innermost scope
+ * open, or NULL if none is
+ */
+struct ScopeListRec * topScope( void )
+{ return current->nOpen ? current->open[current->nOpen-1] : NULL;
+}
+
+/* Function copyString makes a new copy of an
+ * existing string in the compilation in progress
  */
 char * copyString(char * s)
-{ int n;
-  char * t;
+{ char * t;
   if (s==NULL) return NULL;
-  n = strlen(s)+1;
-  t = malloc(n);
+  t = arenaString(&current->arena,s);
   if (t==NULL)
-    fprintf(listing,"Out of memory error at line %d\n",lineno);
-  else strcpy(t,s);
+    fprintf(listing,"Out of memory error at line %d\n",lineOf(tokenOffset));
+  else current->strings++;
   return t;
 }
 
+/* Function symtabAlloc returns n bytes for the
+ * symbol table from the compilation in progress
+ */
+void * symtabAlloc( size_t n )
+{ void * p = arenaAlloc(&current->symtab,n);
+  if (p == NULL) outOfMemory();
+  return p;
+}
+
 /* Variable indentno is used by printTree to
  * store current number of spaces to indent
  */
-static indentno = 0;
-
-/* macros to increase/decrease indentation */
-#define INDENT indentno+=2
-#define UNINDENT indentno-=2
+static int indentno = 0;
 
 /* printSpaces indents by printing spaces */
 static void printSpaces(void)
@@ -128,78 +408,86 @@ static void printSpaces(void)
     fprintf(listing," ");
 }
 
-/* procedure printTree prints a syntax tree to the 
- * listing file using indentation to indicate subtrees
- */
-void printTree( TreeNode * tree )
-{ int i;
-  INDENT;
-  while (tree != NULL) {
-    printSpaces();
-    if (tree->nodekind==StmtK)
-    { switch (tree->kind.stmt) {
-        case VarDeclK:
-          fprintf(listing,"Var declaration, name : %s, type : %s\n",tree->attr.name,tree->attr.type);
-          break;
-        case ArrVarDeclK:
-          fprintf(listing,"Array var declaration, name : %s, size : %d, type : %s\n",tree->attr.name,tree->attr.val,tree->attr.type);
-          break;
-        case FunK:
-          fprintf(listing,"Function declaration, name : %s, return type : %s\n",tree->attr.name,tree->attr.type);
-          break;
-        case ParamK:
-          fprintf(listing,"Single parameter, name : %s, type : %s\n",tree->attr.name,tree->attr.type);
-          break;
-        case ArrParamK:
-          fprintf(listing,"Array parameter, name : %s, type : %s\n",tree->attr.name,tree->attr.type);
-          break;
-        case CompK:
-          fprintf(listing,"Compound statement : \n");
-          break;
-        case IfK:
-          fprintf(listing,"If (condition) (body) (else)\n");
-          break;
-        case WhileK:
-          fprintf(listing,"While\n");
-          break;
-        case RetK:
-          fprintf(listing,"Return :\n");
-          break;
-        case AssignK:
-          fprintf(listing,"Assign: (destination) (source) \n");
-          break;
-        default:
-          fprintf(listing,"Unknown ExpNode kind\n");
-          break;
-      }
+/* declName returns the type name a declaration
+   was written with */
+static char * declName( int decl )
+{ return (decl == Integer) ? "int" : "void";
+}
+
+/* printNode prints the node of f, indented two
+   spaces for each node above it */
+static int printNode( WalkFrame * f )
+{ TreeNode * tree = node(f->node);
+  indentno = 2*(f->depth+1);
+  printSpaces();
+  if (tree->nodekind==StmtK)
+  { switch (tree->kind.stmt) {
+      case VarDeclK:
+        fprintf(listing,"Var declaration, name : %s, type : %s\n",tree->attr.name,declName(tree->decl));
+        break;
+      case ArrVarDeclK:
+        fprintf(listing,"Array var declaration, name : %s, size : %d, type : %s\n",tree->attr.name,arraySize(f->node),declName(tree->decl));
+        break;
+      case FunK:
+        fprintf(listing,"Function declaration, name : %s, return type : %s\n",tree->attr.name,declName(tree->decl));
+        break;
+      case ParamK:
+        fprintf(listing,"Single parameter, name : %s, type : %s\n",tree->attr.name,declName(tree->decl));
+        break;
+      case ArrParamK:
+        fprintf(listing,"Array parameter, name : %s, type : %s\n",tree->attr.name,declName(tree->decl));
+        break;
+      case CompK:
+        fprintf(listing,"Compound statement : \n");
+        break;
+      case IfK:
+        fprintf(listing,"If (condition) (body) (else)\n");
+        break;
+      case WhileK:
+        fprintf(listing,"While\n");
+        break;
+      case RetK:
+        fprintf(listing,"Return :\n");
+        break;
+      case AssignK:
+        fprintf(listing,"Assign: (destination) (source) \n");
+        break;
+      default:
+        fprintf(listing,"Unknown ExpNode kind\n");
+        break;
     }
-    else if (tree->nodekind==ExpK)
-    { switch (tree->kind.exp) {
-        case OpK:
-          fprintf(listing,"Op: ");
-          printToken(tree->attr.op,"\0");
-          break;
-        case ConstK:
-          fprintf(listing,"Const: %d\n",tree->attr.val);
-          break;
-        case IdK:
-          fprintf(listing,"Id: %s\n",tree->attr.name);
-          break;
-        case ArrIdK:
-          fprintf(listing,"ArrId: %s, with index below\n",tree->attr.name);
-          break;
-        case CallK:
-          fprintf(listing,"Call, name : %s, with arguments below\n",tree->attr.name);
-          break;
-        default:
-          fprintf(listing,"Unknown ExpNode kind\n");
-          break;
-      }
+  }
+  else if (tree->nodekind==ExpK)
+  { switch (tree->kind.exp) {
+      case OpK:
+        fprintf(listing,"Op: ");
+        printToken(tree->attr.op,"\0");
+        break;
+      case ConstK:
+        fprintf(listing,"Const: %d\n",tree->attr.val);
+        break;
+      case IdK:
+        fprintf(listing,"Id: %s\n",tree->attr.name);
+        break;
+      case ArrIdK:
+        fprintf(listing,"ArrId: %s, with index below\n",tree->attr.name);
+        break;
+      case CallK:
+        fprintf(listing,"Call, name : %s, with arguments below\n",tree->attr.name);
+        break;
+      default:
+        fprintf(listing,"Unknown ExpNode kind\n");
+        break;
     }
-    else fprintf(listing,"Unknown node kind\n");
-    for (i=0;i<MAXCHILDREN;i++)
-         printTree(tree->child[i]);
-    tree = tree->sibling;
   }
-  UNINDENT;
+  else fprintf(listing,"Unknown node kind\n");
+  return ALLCHILDREN;
+}
+
+/* procedure printTree prints a syntax tree to the 
+ * listing file using indentation to indicate subtrees
+ */
+void printTree( NodeId n )
+{ static const WalkProcs procs = {printNode,NULL,NULL};
+  walkTree(n,&procs);
 }
@@ -8,29 +8,191 @@
 #ifndef _UTIL_H_
 #define _UTIL_H_
 
+#include "arena.h"
+
 /* Procedure printToken prints a token 
  * and its lexeme to the listing file
  */
 void printToken( TokenType, const char* );
 
+/* Procedure printTokenSpan prints a token and
+ * the len characters of its lexeme at s, which
+ * need not end in '\0'
+ */
+void printTokenSpan( TokenType, const char *, int );
+
+/* NODESHIFT = log2 of the nodes in a chunk of the
+   node array; chunks never move once made, so a
+   TreeNode * stays good for the whole compilation */
+#define NODESHIFT 12
+#define NODECHUNK (1 << NODESHIFT)
+
+struct ScopeListRec;
+struct BucketListRec;
+
+/* an entry of the array size side table */
+typedef struct
+   { NodeId node; /* an ArrVarDeclK node */
+     int size;
+   } ArraySize;
+
+/* an entry of the table of the top-level
+   declarations of the program, in order */
+typedef struct
+   { NodeId node; /* the declaration */
+     int start;   /* offset in srcText of its first token */
+   } TopDecl;
+
+/* A Compilation owns the syntax tree of one source
+ * program: between beginCompilation and
+ * endCompilation, newStmtNode and newExpNode add to
+ * its node array, and copyString takes memory from
+ * its arena, as do the chunks of the node array;
+ * endCompilation releases it all in one call. The
+ * counts and the arena's byte totals say how much
+ * the tree took. The symbol table built from the
+ * tree takes its memory from an arena of its own,
+ * released along with the tree. Nodes made outside
+ * any compilation go into one that lasts as long as
+ * the compiler. Node 0 is reserved, so NONODE is
+ * never a node.
+ * The nodes may instead come from a mapped file
+ * (see adoptNodes), which endCompilation unmaps
+ */
+typedef struct
+   { Arena arena;        /* the node chunks and strings */
+     Arena symtab;       /* the scopes, buckets and lines */
+     TreeNode ** chunks; /* the node array, chunk by chunk */
+     int nChunks, maxChunks;
+     NodeId nodes;       /* nodes made, node 0 included */
+     ArraySize * sizes;  /* side table of array sizes, by node */
+     int nSizes, maxSizes;
+     TopDecl * decls;    /* table of top-level declarations */
+     int nDecls, maxDecls;
+     struct ScopeListRec ** scopes; /* side table of scopes, indexed by node */
+     NodeId maxScopes;
+     struct BucketListRec ** symbols; /* side table of symbols, indexed by node */
+     NodeId maxSymbols;
+     struct ScopeListRec ** made; /* the scopes made, in order */
+     int nMade, maxMade;
+     struct ScopeListRec ** open; /* the scopes open, innermost last */
+     int nOpen, maxOpen;
+     long stmtNodes;     /* statement nodes made */
+     long expNodes;      /* expression nodes made */
+     long strings;       /* strings copied */
+     void * map;         /* mapping the nodes came in, or NULL */
+     size_t mapLen;
+   } Compilation;
+
+/* nodeChunks is the node array of the compilation
+ * in progress, for node
+ */
+extern TreeNode ** nodeChunks;
+
+/* Macro node returns the node n of the compilation
+ * in progress; node(NONODE) is a node of zeroes
+ */
+#define node(n) (&nodeChunks[(n) >> NODESHIFT][(n) & (NODECHUNK-1)])
+
+/* Procedure beginCompilation empties c and makes
+ * it the compilation new nodes belong to
+ */
+void beginCompilation( Compilation * c );
+
+/* Procedure endCompilation releases the syntax tree
+ * of c, which must be the compilation in progress.
+ * The counts are kept, so they can be read after
+ */
+void endCompilation( Compilation * c );
+
 /* Function newStmtNode creates a new statement
  * node for syntax tree construction
  */
-TreeNode * newStmtNode(StmtKind);
+NodeId newStmtNode(StmtKind);
 
 /* Function newExpNode creates a new expression 
  * node for syntax tree construction
  */
-TreeNode * newExpNode(ExpKind);
+NodeId newExpNode(ExpKind);
 
-/* Function copyString allocates and makes a new
- * copy of an existing string
+/* Function nodeCount returns the number of nodes
+ * made in the compilation in progress, node 0
+ * included; nodes are numbered from 0 up to it
+ */
+NodeId nodeCount( void );
+
+/* Procedure adoptNodes makes the n nodes at nodes,
+ * node 0 included, the node array of the compilation
+ * in progress, which must have no nodes yet, as if
+ * stmtNodes statement and expNodes expression nodes
+ * had been made. The array must have room for whole
+ * chunks, zeroed past node n, since nodes made after
+ * go on at its end. It lies in the mapping of
+ * mapLen bytes at map, unmapped by endCompilation
+ */
+void adoptNodes( TreeNode * nodes, NodeId n, long stmtNodes, long expNodes,
+                 void * map, size_t mapLen );
+
+/* Function arraySize returns the size recorded for
+ * the array declaration n, or 0 if none is.
+ * setArraySize records it; sizes must be recorded
+ * in the order the nodes were made
+ */
+int arraySize( NodeId n );
+void setArraySize( NodeId n, int size );
+
+/* Procedure addTopDecl adds the declaration n,
+ * starting at offset start, to the end of the table
+ * of top-level declarations. topDecls returns the
+ * table and sets *n to its length. replaceTopDecls
+ * makes the n entries at decls, malloc'd, the table
+ */
+void addTopDecl( NodeId n, int start );
+TopDecl * topDecls( int * n );
+void replaceTopDecls( TopDecl * decls, int n );
+
+/* Function nodeScope returns the scope recorded for
+ * node n, or NULL if none is; setNodeScope records
+ * it
+ */
+struct ScopeListRec * nodeScope( NodeId n );
+void setNodeScope( NodeId n, struct ScopeListRec * s );
+
+/* Function nodeSymbol returns the symbol (the
+ * declaration's bucket, see symtab.h) a name at
+ * node n was resolved to, or NULL if none is;
+ * setNodeSymbol records it
+ */
+struct BucketListRec * nodeSymbol( NodeId n );
+void setNodeSymbol( NodeId n, struct BucketListRec * b );
+
+/* Procedure addScope adds the scope s to the end of
+ * the list of scopes made; madeScopes returns the
+ * list and sets *n to its length. pushScope,
+ * popScope and topScope work the stack of the
+ * scopes open, topScope returning NULL when none is.
+ * Both grow as they must
+ */
+void addScope( struct ScopeListRec * s );
+struct ScopeListRec ** madeScopes( int * n );
+void pushScope( struct ScopeListRec * s );
+struct ScopeListRec * popScope( void );
+struct ScopeListRec * topScope( void );
+
+/* Function copyString makes a new copy of an
+ * existing string in the compilation in progress
  */
 char * copyString( char * );
 
+/* Function symtabAlloc returns n bytes for the
+ * symbol table from the compilation in progress,
+ * aligned for any type
+ */
+void * symtabAlloc( size_t n );
+
 /* procedure printTree prints a syntax tree to the 
  * listing file using indentation to indicate subtrees
  */
-void printTree( TreeNode * );
+void printTree( NodeId );
 
 #endif
@@ -0,0 +1,82 @@
+/****************************************************/
+/* File: walk.c                                     */
+/* Syntax tree traversal engine shared by the       */
+/* passes of the C-Minus compiler                   */
+/****************************************************/
+
+#include "globals.h"
+#include "util.h"
+#include "walk.h"
+
+/* INITFRAMES = frames the stack starts with; it
+   doubles whenever it fills */
+#define INITFRAMES 64
+
+/* startFrame makes f the frame of a node not yet
+   visited */
+static void startFrame( WalkFrame * f, NodeId n, int depth )
+{ f->node = n;
+  f->depth = depth;
+  f->mask = -1;
+  f->next = 0;
+  f->local[0] = f->local[1] = 0;
+}
+
+/* Procedure walkTree applies the hooks of p to the
+ * tree t and its siblings. A frame is pushed for a
+ * child and popped when the child's list is done; a
+ * sibling reuses the frame of the node before it
+ */
+void walkTree( NodeId t, const WalkProcs * p )
+{ WalkFrame * stack;
+  int max = INITFRAMES;
+  int top = 0;
+  if (t == NONODE) return;
+  stack = (WalkFrame *) malloc(max*sizeof(WalkFrame));
+  if (stack == NULL)
+  { fprintf(listing,"Out of memory error walking the syntax tree\n");
+    exit(1);
+  }
+  startFrame(&stack[0],t,0);
+  while (top >= 0)
+  { WalkFrame * f = &stack[top];
+    TreeNode * n = node(f->node);
+    if (f->mask < 0)
+      f->mask = (p->pre != NULL) ? p->pre(f) : ALLCHILDREN;
+    while ((f->next < MAXCHILDREN) && !(f->mask & CHILD(f->next)))
+      f->next++;
+    if (f->next < MAXCHILDREN)
+    { NodeId c = n->child[f->next];
+      if (c != NONODE)
+      { if (top+1 == max)
+        { WalkFrame * s = (WalkFrame *) realloc(stack,2*max*sizeof(WalkFrame));
+          if (s == NULL)
+          { fprintf(listing,"Out of memory error walking the syntax tree\n");
+            exit(1);
+          }
+          stack = s;
+          max *= 2;
+          f = &stack[top];
+        }
+        startFrame(&stack[top+1],c,f->depth+1);
+        top++;
+        continue;
+      }
+      if (p->in != NULL) p->in(f,f->next);
+      f->next++;
+      continue;
+    }
+    if (p->post != NULL) p->post(f);
+    if (n->sibling != NONODE)
+    { startFrame(f,n->sibling,f->depth);
+      continue;
+    }
+    /* the list is done: back to the node it hangs from */
+    if (--top >= 0)
+    { f = &stack[top];
+      if (p->in != NULL) p->in(f,f->next);
+      f->next++;
+    }
+  }
+  free(stack);
+}
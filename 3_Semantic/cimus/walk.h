@@ -0,0 +1,53 @@
+/****************************************************/
+/* File: walk.h                                     */
+/* Syntax tree traversal engine shared by the       */
+/* passes of the C-Minus compiler                   */
+/****************************************************/
+
+#ifndef _WALK_H_
+#define _WALK_H_
+
+/* walkTree visits a node, its children and then its
+ * siblings without recursing: the nodes it is inside
+ * are kept on an explicit stack of WalkFrames, so a
+ * pass runs in the same native stack however deep
+ * the tree is nested and however long its lists are
+ */
+
+/* CHILD(i) is the bit of child i in a child mask;
+   ALLCHILDREN has the bits of every child */
+#define CHILD(i) (1 << (i))
+#define ALLCHILDREN (CHILD(MAXCHILDREN)-1)
+
+/* WalkFrame describes the node being visited and is
+ * passed to each hook called for it. local holds
+ * whatever the pass wants to keep between its hooks
+ * at the node; it starts out zero
+ */
+typedef struct
+   { NodeId node;
+     int depth;   /* nodes above this one; 0 for the root's list */
+     int mask;    /* children to visit, from pre */
+     int next;    /* child to visit next */
+     int local[2];
+   } WalkFrame;
+
+/* WalkProcs are the hooks of a pass; any may be
+ * NULL. pre is called before the children of a node
+ * and returns the mask of the children to visit, in
+ * order (NULL visits them all); in is called after
+ * each of those children, even a missing one; post
+ * is called after the last, before the siblings
+ */
+typedef struct
+   { int (* pre) (WalkFrame *);
+     void (* in) (WalkFrame *, int child);
+     void (* post) (WalkFrame *);
+   } WalkProcs;
+
+/* Procedure walkTree applies the hooks of p to the
+ * tree t and its siblings
+ */
+void walkTree( NodeId t, const WalkProcs * p );
+
+#endif
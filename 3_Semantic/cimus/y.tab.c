@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison implementation for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -33,6 +34,10 @@
 /* C LALR(1) parser skeleton written by Richard Stallman, by
    simplifying the original so-called "semantic" parser.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 /* All symbols defined below should begin with yy or YY, to avoid
    infringing on user name space.  This should be done even for local
    variables, as they might otherwise be expanded by user macros.
@@ -40,11 +45,11 @@
    define necessary library symbols; they are noted "INFRINGES ON
    USER NAME SPACE" below.  */
 
-/* Identify Bison output.  */
-#define YYBISON 1
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
 
-/* Bison version.  */
-#define YYBISON_VERSION "3.0.4"
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
 
 /* Skeleton name.  */
 #define YYSKELETON_NAME "yacc.c"
@@ -53,16 +58,16 @@
 #define YYPURE 0
 
 /* Push parsers.  */
-#define YYPUSH 0
+#define YYPUSH 1
 
 /* Pull parsers.  */
-#define YYPULL 1
+#define YYPULL 0
 
 
 
 
-/* Copy the first part of user declarations.  */
-#line 7 "cminus.y" /* yacc.c:339  */
+/* First part of user prologue.  */
+#line 7 "cminus.y"
 
 #define YYPARSER /* distinguishes Yacc output from other code files */
 
@@ -70,36 +75,53 @@
 #include "util.h"
 #include "scan.h"
 #include "parse.h"
-
-#define YYSTYPE TreeNode *
-static char * savedName; /* for use in assignments */
-static int savedLineNo;  /* ditto */
-static TreeNode * savedTree; /* stores syntax tree for later return */
-static int yylex(void); // added 11/2/11 to ensure no conflict with lex
-static int savedSize;
-static char * savedType;
-
-
-#line 84 "y.tab.c" /* yacc.c:339  */
-
+#include "intern.h"
+#include "lineidx.h"
+#include "source.h"
+
+/* a location is the offset of a token in srcText
+ * (see scan.h); a rule is located at its first
+ * symbol, and an empty one where the symbol
+ * before it is */
+#define YYLTYPE int
+#define YYLLOC_DEFAULT(Cur,Rhs,N) \
+  ((Cur) = (N) ? YYRHSLOC(Rhs,1) : YYRHSLOC(Rhs,0))
+static NodeId savedTree; /* stores syntax tree for later return */
+/* the token being pushed, for yyerror */
+static const TokenRec * pushedToken;
+static char * nullName; /* name of a void parameter list */
+static int numValue(const TokenRec * tok);
+int yyerror(char * message);
+static NodeId appendList(NodeId last, NodeId t);
+static NodeId closeList(NodeId last);
+static NodeId newOp(NodeId left, TokenType op, NodeId right);
+
+
+#line 101 "y.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
 # ifndef YY_NULLPTR
-#  if defined __cplusplus && 201103L <= __cplusplus
-#   define YY_NULLPTR nullptr
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
 #  else
-#   define YY_NULLPTR 0
+#   define YY_NULLPTR ((void*)0)
 #  endif
 # endif
 
-/* Enabling verbose error messages.  */
-#ifdef YYERROR_VERBOSE
-# undef YYERROR_VERBOSE
-# define YYERROR_VERBOSE 1
-#else
-# define YYERROR_VERBOSE 0
-#endif
-
-/* In a future release of Bison, this section will be replaced
-   by #include "y.tab.h".  */
+/* Use api.header.include to #include this header
+   instead of duplicating it here.  */
 #ifndef YY_YY_Y_TAB_H_INCLUDED
 # define YY_YY_Y_TAB_H_INCLUDED
 /* Debug traces.  */
@@ -110,49 +132,57 @@ static char * savedType;
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    IF = 258,
-    ELSE = 259,
-    WHILE = 260,
-    RETURN = 261,
-    INT = 262,
-    VOID = 263,
-    THEN = 264,
-    END = 265,
-    REPEAT = 266,
-    UNTIL = 267,
-    READ = 268,
-    WRITE = 269,
-    ID = 270,
-    NUM = 271,
-    ASSIGN = 272,
-    EQ = 273,
-    NE = 274,
-    LT = 275,
-    LE = 276,
-    GE = 277,
-    GT = 278,
-    PLUS = 279,
-    MINUS = 280,
-    TIMES = 281,
-    OVER = 282,
-    LPAREN = 283,
-    RPAREN = 284,
-    LBRACE = 285,
-    RBRACE = 286,
-    LCURLY = 287,
-    RCURLY = 288,
-    SEMI = 289,
-    COMMA = 290,
-    ERROR = 291,
-    LOWER_THAN_ELSE = 292
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IF = 258,                      /* IF  */
+    ELSE = 259,                    /* ELSE  */
+    WHILE = 260,                   /* WHILE  */
+    RETURN = 261,                  /* RETURN  */
+    INT = 262,                     /* INT  */
+    VOID = 263,                    /* VOID  */
+    THEN = 264,                    /* THEN  */
+    END = 265,                     /* END  */
+    REPEAT = 266,                  /* REPEAT  */
+    UNTIL = 267,                   /* UNTIL  */
+    READ = 268,                    /* READ  */
+    WRITE = 269,                   /* WRITE  */
+    ID = 270,                      /* ID  */
+    NUM = 271,                     /* NUM  */
+    ASSIGN = 272,                  /* ASSIGN  */
+    EQ = 273,                      /* EQ  */
+    NE = 274,                      /* NE  */
+    LT = 275,                      /* LT  */
+    LE = 276,                      /* LE  */
+    GE = 277,                      /* GE  */
+    GT = 278,                      /* GT  */
+    PLUS = 279,                    /* PLUS  */
+    MINUS = 280,                   /* MINUS  */
+    TIMES = 281,                   /* TIMES  */
+    OVER = 282,                    /* OVER  */
+    LPAREN = 283,                  /* LPAREN  */
+    RPAREN = 284,                  /* RPAREN  */
+    LBRACE = 285,                  /* LBRACE  */
+    RBRACE = 286,                  /* RBRACE  */
+    LCURLY = 287,                  /* LCURLY  */
+    RCURLY = 288,                  /* RCURLY  */
+    SEMI = 289,                    /* SEMI  */
+    COMMA = 290,                   /* COMMA  */
+    ERROR = 291                    /* ERROR  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
 #define IF 258
 #define ELSE 259
 #define WHILE 260
@@ -187,52 +217,213 @@ extern int yydebug;
 #define SEMI 289
 #define COMMA 290
 #define ERROR 291
-#define LOWER_THAN_ELSE 292
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef int YYSTYPE;
+union YYSTYPE
+{
+#line 43 "cminus.y"
+ unsigned int node; char * name; int val; int type; 
+
+#line 229 "y.tab.c"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define YYSTYPE_IS_DECLARED 1
 #endif
 
+/* Location type.  */
+#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
+typedef struct YYLTYPE YYLTYPE;
+struct YYLTYPE
+{
+  int first_line;
+  int first_column;
+  int last_line;
+  int last_column;
+};
+# define YYLTYPE_IS_DECLARED 1
+# define YYLTYPE_IS_TRIVIAL 1
+#endif
+
 
 extern YYSTYPE yylval;
+extern YYLTYPE yylloc;
+
+#ifndef YYPUSH_MORE_DEFINED
+# define YYPUSH_MORE_DEFINED
+enum { YYPUSH_MORE = 4 };
+#endif
+
+typedef struct yypstate yypstate;
+
+
+int yypush_parse (yypstate *ps);
+
+yypstate *yypstate_new (void);
+void yypstate_delete (yypstate *ps);
 
-int yyparse (void);
 
 #endif /* !YY_YY_Y_TAB_H_INCLUDED  */
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IF = 3,                         /* IF  */
+  YYSYMBOL_ELSE = 4,                       /* ELSE  */
+  YYSYMBOL_WHILE = 5,                      /* WHILE  */
+  YYSYMBOL_RETURN = 6,                     /* RETURN  */
+  YYSYMBOL_INT = 7,                        /* INT  */
+  YYSYMBOL_VOID = 8,                       /* VOID  */
+  YYSYMBOL_THEN = 9,                       /* THEN  */
+  YYSYMBOL_END = 10,                       /* END  */
+  YYSYMBOL_REPEAT = 11,                    /* REPEAT  */
+  YYSYMBOL_UNTIL = 12,                     /* UNTIL  */
+  YYSYMBOL_READ = 13,                      /* READ  */
+  YYSYMBOL_WRITE = 14,                     /* WRITE  */
+  YYSYMBOL_ID = 15,                        /* ID  */
+  YYSYMBOL_NUM = 16,                       /* NUM  */
+  YYSYMBOL_ASSIGN = 17,                    /* ASSIGN  */
+  YYSYMBOL_EQ = 18,                        /* EQ  */
+  YYSYMBOL_NE = 19,                        /* NE  */
+  YYSYMBOL_LT = 20,                        /* LT  */
+  YYSYMBOL_LE = 21,                        /* LE  */
+  YYSYMBOL_GE = 22,                        /* GE  */
+  YYSYMBOL_GT = 23,                        /* GT  */
+  YYSYMBOL_PLUS = 24,                      /* PLUS  */
+  YYSYMBOL_MINUS = 25,                     /* MINUS  */
+  YYSYMBOL_TIMES = 26,                     /* TIMES  */
+  YYSYMBOL_OVER = 27,                      /* OVER  */
+  YYSYMBOL_LPAREN = 28,                    /* LPAREN  */
+  YYSYMBOL_RPAREN = 29,                    /* RPAREN  */
+  YYSYMBOL_LBRACE = 30,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 31,                    /* RBRACE  */
+  YYSYMBOL_LCURLY = 32,                    /* LCURLY  */
+  YYSYMBOL_RCURLY = 33,                    /* RCURLY  */
+  YYSYMBOL_SEMI = 34,                      /* SEMI  */
+  YYSYMBOL_COMMA = 35,                     /* COMMA  */
+  YYSYMBOL_ERROR = 36,                     /* ERROR  */
+  YYSYMBOL_YYACCEPT = 37,                  /* $accept  */
+  YYSYMBOL_program = 38,                   /* program  */
+  YYSYMBOL_decl_list = 39,                 /* decl_list  */
+  YYSYMBOL_decl = 40,                      /* decl  */
+  YYSYMBOL_var_decl = 41,                  /* var_decl  */
+  YYSYMBOL_type_spec = 42,                 /* type_spec  */
+  YYSYMBOL_fun_decl = 43,                  /* fun_decl  */
+  YYSYMBOL_params = 44,                    /* params  */
+  YYSYMBOL_param_list = 45,                /* param_list  */
+  YYSYMBOL_param = 46,                     /* param  */
+  YYSYMBOL_comp_stmt = 47,                 /* comp_stmt  */
+  YYSYMBOL_local_decl = 48,                /* local_decl  */
+  YYSYMBOL_stmt_list = 49,                 /* stmt_list  */
+  YYSYMBOL_stmt = 50,                      /* stmt  */
+  YYSYMBOL_matched_stmt = 51,              /* matched_stmt  */
+  YYSYMBOL_unmatched_stmt = 52,            /* unmatched_stmt  */
+  YYSYMBOL_exp_stmt = 53,                  /* exp_stmt  */
+  YYSYMBOL_ret_stmt = 54,                  /* ret_stmt  */
+  YYSYMBOL_exp = 55,                       /* exp  */
+  YYSYMBOL_var = 56,                       /* var  */
+  YYSYMBOL_simple_exp = 57,                /* simple_exp  */
+  YYSYMBOL_term = 58,                      /* term  */
+  YYSYMBOL_factor = 59,                    /* factor  */
+  YYSYMBOL_call = 60,                      /* call  */
+  YYSYMBOL_args = 61,                      /* args  */
+  YYSYMBOL_arg_list = 62                   /* arg_list  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
 
-/* Copy the second part of user declarations.  */
 
-#line 209 "y.tab.c" /* yacc.c:358  */
 
 #ifdef short
 # undef short
 #endif
 
-#ifdef YYTYPE_UINT8
-typedef YYTYPE_UINT8 yytype_uint8;
-#else
-typedef unsigned char yytype_uint8;
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
 #endif
 
-#ifdef YYTYPE_INT8
-typedef YYTYPE_INT8 yytype_int8;
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
 #else
 typedef signed char yytype_int8;
 #endif
 
-#ifdef YYTYPE_UINT16
-typedef YYTYPE_UINT16 yytype_uint16;
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
 #else
-typedef unsigned short int yytype_uint16;
+typedef short yytype_int16;
 #endif
 
-#ifdef YYTYPE_INT16
-typedef YYTYPE_INT16 yytype_int16;
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
 #else
-typedef short int yytype_int16;
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
 #endif
 
 #ifndef YYSIZE_T
@@ -240,15 +431,28 @@ typedef short int yytype_int16;
 #  define YYSIZE_T __SIZE_TYPE__
 # elif defined size_t
 #  define YYSIZE_T size_t
-# elif ! defined YYSIZE_T
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
 #  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
 #  define YYSIZE_T size_t
 # else
-#  define YYSIZE_T unsigned int
+#  define YYSIZE_T unsigned
 # endif
 #endif
 
-#define YYSIZE_MAXIMUM ((YYSIZE_T) -1)
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int8 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
 
 #ifndef YY_
 # if defined YYENABLE_NLS && YYENABLE_NLS
@@ -262,47 +466,43 @@ typedef short int yytype_int16;
 # endif
 #endif
 
-#ifndef YY_ATTRIBUTE
-# if (defined __GNUC__                                               \
-      && (2 < __GNUC__ || (__GNUC__ == 2 && 96 <= __GNUC_MINOR__)))  \
-     || defined __SUNPRO_C && 0x5110 <= __SUNPRO_C
-#  define YY_ATTRIBUTE(Spec) __attribute__(Spec)
-# else
-#  define YY_ATTRIBUTE(Spec) /* empty */
-# endif
-#endif
 
 #ifndef YY_ATTRIBUTE_PURE
-# define YY_ATTRIBUTE_PURE   YY_ATTRIBUTE ((__pure__))
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
 #endif
 
 #ifndef YY_ATTRIBUTE_UNUSED
-# define YY_ATTRIBUTE_UNUSED YY_ATTRIBUTE ((__unused__))
-#endif
-
-#if !defined _Noreturn \
-     && (!defined __STDC_VERSION__ || __STDC_VERSION__ < 201112)
-# if defined _MSC_VER && 1200 <= _MSC_VER
-#  define _Noreturn __declspec (noreturn)
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
 # else
-#  define _Noreturn YY_ATTRIBUTE ((__noreturn__))
+#  define YY_ATTRIBUTE_UNUSED
 # endif
 #endif
 
 /* Suppress unused-variable warnings by "using" E.  */
 #if ! defined lint || defined __GNUC__
-# define YYUSE(E) ((void) (E))
+# define YY_USE(E) ((void) (E))
 #else
-# define YYUSE(E) /* empty */
+# define YY_USE(E) /* empty */
 #endif
 
-#if defined __GNUC__ && 407 <= __GNUC__ * 100 + __GNUC_MINOR__
 /* Suppress an incorrect diagnostic about yylval being uninitialized.  */
-# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN \
-    _Pragma ("GCC diagnostic push") \
-    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")\
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
     _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
-# define YY_IGNORE_MAYBE_UNINITIALIZED_END \
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
     _Pragma ("GCC diagnostic pop")
 #else
 # define YY_INITIAL_VALUE(Value) Value
@@ -315,34 +515,24 @@ typedef short int yytype_int16;
 # define YY_INITIAL_VALUE(Value) /* Nothing. */
 #endif
 
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
 
-#if ! defined yyoverflow || YYERROR_VERBOSE
 
-/* The parser invokes alloca or malloc; define the necessary symbols.  */
+#define YY_ASSERT(E) ((void) (0 && (E)))
 
-# ifdef YYSTACK_USE_ALLOCA
-#  if YYSTACK_USE_ALLOCA
-#   ifdef __GNUC__
-#    define YYSTACK_ALLOC __builtin_alloca
-#   elif defined __BUILTIN_VA_ARG_INCR
-#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
-#   elif defined _AIX
-#    define YYSTACK_ALLOC __alloca
-#   elif defined _MSC_VER
-#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
-#    define alloca _alloca
-#   else
-#    define YYSTACK_ALLOC alloca
-#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
-#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
-      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
-#     ifndef EXIT_SUCCESS
-#      define EXIT_SUCCESS 0
-#     endif
-#    endif
-#   endif
-#  endif
-# endif
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
 
 # ifdef YYSTACK_ALLOC
    /* Pacify GCC's 'empty if-body' warning.  */
@@ -381,28 +571,30 @@ void free (void *); /* INFRINGES ON USER NAME SPACE */
 #   endif
 #  endif
 # endif
-#endif /* ! defined yyoverflow || YYERROR_VERBOSE */
-
+#endif /* !defined yyoverflow */
 
 #if (! defined yyoverflow \
      && (! defined __cplusplus \
-         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+         || (defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL \
+             && defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
 
 /* A type that is properly aligned for any stack member.  */
 union yyalloc
 {
-  yytype_int16 yyss_alloc;
+  yy_state_t yyss_alloc;
   YYSTYPE yyvs_alloc;
+  YYLTYPE yyls_alloc;
 };
 
 /* The size of the maximum gap between one aligned stack and the next.  */
-# define YYSTACK_GAP_MAXIMUM (sizeof (union yyalloc) - 1)
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
 
 /* The size of an array large to enough to hold all stacks, each with
    N elements.  */
 # define YYSTACK_BYTES(N) \
-     ((N) * (sizeof (yytype_int16) + sizeof (YYSTYPE)) \
-      + YYSTACK_GAP_MAXIMUM)
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE) \
+             + YYSIZEOF (YYLTYPE)) \
+      + 2 * YYSTACK_GAP_MAXIMUM)
 
 # define YYCOPY_NEEDED 1
 
@@ -414,11 +606,11 @@ union yyalloc
 # define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
     do                                                                  \
       {                                                                 \
-        YYSIZE_T yynewbytes;                                            \
+        YYPTRDIFF_T yynewbytes;                                         \
         YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
         Stack = &yyptr->Stack_alloc;                                    \
-        yynewbytes = yystacksize * sizeof (*Stack) + YYSTACK_GAP_MAXIMUM; \
-        yyptr += yynewbytes / sizeof (*yyptr);                          \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
       }                                                                 \
     while (0)
 
@@ -430,12 +622,12 @@ union yyalloc
 # ifndef YYCOPY
 #  if defined __GNUC__ && 1 < __GNUC__
 #   define YYCOPY(Dst, Src, Count) \
-      __builtin_memcpy (Dst, Src, (Count) * sizeof (*(Src)))
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
 #  else
 #   define YYCOPY(Dst, Src, Count)              \
       do                                        \
         {                                       \
-          YYSIZE_T yyi;                         \
+          YYPTRDIFF_T yyi;                      \
           for (yyi = 0; yyi < (Count); yyi++)   \
             (Dst)[yyi] = (Src)[yyi];            \
         }                                       \
@@ -450,25 +642,28 @@ union yyalloc
 #define YYLAST   115
 
 /* YYNTOKENS -- Number of terminals.  */
-#define YYNTOKENS  38
+#define YYNTOKENS  37
 /* YYNNTS -- Number of nonterminals.  */
-#define YYNNTS  32
+#define YYNNTS  26
 /* YYNRULES -- Number of rules.  */
-#define YYNRULES  65
+#define YYNRULES  61
 /* YYNSTATES -- Number of states.  */
-#define YYNSTATES  111
+#define YYNSTATES  108
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   291
 
-/* YYTRANSLATE[YYX] -- Symbol number corresponding to YYX as returned
-   by yylex, with out-of-bounds checking.  */
-#define YYUNDEFTOK  2
-#define YYMAXUTOK   292
 
-#define YYTRANSLATE(YYX)                                                \
-  ((unsigned int) (YYX) <= YYMAXUTOK ? yytranslate[YYX] : YYUNDEFTOK)
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
 
 /* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
-   as returned by yylex, without out-of-bounds checking.  */
-static const yytype_uint8 yytranslate[] =
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
 {
        0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
        2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
@@ -499,229 +694,250 @@ static const yytype_uint8 yytranslate[] =
        5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
       15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
       25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
-      35,    36,    37
+      35,    36
 };
 
 #if YYDEBUG
-  /* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
-static const yytype_uint16 yyrline[] =
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
 {
-       0,    36,    36,    39,    48,    50,    52,    55,    61,    69,
-      71,    75,    74,    86,    88,    95,   104,   107,   113,   120,
-     126,   135,   137,   146,   148,   150,   152,   154,   156,   159,
-     161,   164,   170,   177,   183,   187,   193,   192,   203,   210,
-     217,   224,   231,   238,   245,   248,   254,   253,   263,   270,
-     277,   280,   286,   292,   295,   297,   299,   301,   307,   306,
-     315,   317,   319,   328,   331,   337
+       0,    63,    63,    66,    70,    75,    77,    80,    86,    94,
+      96,    99,   108,   110,   117,   119,   122,   128,   135,   142,
+     144,   146,   148,   154,   156,   159,   161,   163,   165,   172,
+     179,   186,   193,   200,   202,   205,   210,   216,   223,   225,
+     227,   229,   231,   233,   235,   238,   243,   250,   252,   254,
+     257,   259,   261,   264,   266,   268,   270,   276,   283,   285,
+     287,   289
 };
 #endif
 
-#if YYDEBUG || YYERROR_VERBOSE || 0
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
 /* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
    First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
 static const char *const yytname[] =
 {
-  "$end", "error", "$undefined", "IF", "ELSE", "WHILE", "RETURN", "INT",
-  "VOID", "THEN", "END", "REPEAT", "UNTIL", "READ", "WRITE", "ID", "NUM",
-  "ASSIGN", "EQ", "NE", "LT", "LE", "GE", "GT", "PLUS", "MINUS", "TIMES",
-  "OVER", "LPAREN", "RPAREN", "LBRACE", "RBRACE", "LCURLY", "RCURLY",
-  "SEMI", "COMMA", "ERROR", "LOWER_THAN_ELSE", "$accept", "program",
-  "decl_list", "decl", "var_decl", "type_spec", "fun_decl", "@1", "params",
+  "\"end of file\"", "error", "\"invalid token\"", "IF", "ELSE", "WHILE",
+  "RETURN", "INT", "VOID", "THEN", "END", "REPEAT", "UNTIL", "READ",
+  "WRITE", "ID", "NUM", "ASSIGN", "EQ", "NE", "LT", "LE", "GE", "GT",
+  "PLUS", "MINUS", "TIMES", "OVER", "LPAREN", "RPAREN", "LBRACE", "RBRACE",
+  "LCURLY", "RCURLY", "SEMI", "COMMA", "ERROR", "$accept", "program",
+  "decl_list", "decl", "var_decl", "type_spec", "fun_decl", "params",
   "param_list", "param", "comp_stmt", "local_decl", "stmt_list", "stmt",
-  "exp_stmt", "sel_stmt", "iter_stmt", "ret_stmt", "exp", "@2", "var",
-  "@3", "simple_exp", "term", "factor", "call", "@4", "args", "arg_list",
-  "id", "num", YY_NULLPTR
+  "matched_stmt", "unmatched_stmt", "exp_stmt", "ret_stmt", "exp", "var",
+  "simple_exp", "term", "factor", "call", "args", "arg_list", YY_NULLPTR
 };
-#endif
 
-# ifdef YYPRINT
-/* YYTOKNUM[NUM] -- (External) token number corresponding to the
-   (internal) symbol number NUM (which must be that of a token).  */
-static const yytype_uint16 yytoknum[] =
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
 {
-       0,   256,   257,   258,   259,   260,   261,   262,   263,   264,
-     265,   266,   267,   268,   269,   270,   271,   272,   273,   274,
-     275,   276,   277,   278,   279,   280,   281,   282,   283,   284,
-     285,   286,   287,   288,   289,   290,   291,   292
-};
-# endif
+  return yytname[yysymbol];
+}
+#endif
 
-#define YYPACT_NINF -92
+#define YYPACT_NINF (-90)
 
-#define yypact_value_is_default(Yystate) \
-  (!!((Yystate) == (-92)))
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
 
-#define YYTABLE_NINF -59
+#define YYTABLE_NINF (-14)
 
-#define yytable_value_is_error(Yytable_value) \
+#define yytable_value_is_error(Yyn) \
   0
 
-  /* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
-     STATE-NUM.  */
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
 static const yytype_int8 yypact[] =
 {
-      28,   -92,   -92,     7,    28,   -92,   -92,    -3,   -92,   -92,
-     -92,   -92,    -5,    11,   -92,    12,   -92,    22,    67,    27,
-      36,    -3,    38,    42,   -92,   -92,    39,    41,    28,    63,
-     -92,   -92,   -92,   -92,    28,   -92,    -3,    -2,    -5,    69,
-      70,     0,   -92,    48,   -92,   -92,   -92,   -92,   -92,   -92,
-     -92,   -92,    65,    83,    66,    53,   -92,   -92,    -6,    48,
-      48,   -92,    68,    72,   -92,    86,    48,    48,    48,    48,
-      48,    48,    48,    48,    48,    48,    74,    77,    78,    79,
-     -92,   -92,    48,   -92,    57,    57,    57,    57,    57,    57,
-      53,    53,   -92,   -92,    48,    48,     5,     5,   -92,    47,
-     -92,    80,    71,   106,   -92,   -92,   -92,    48,     5,   -92,
-     -92
+      34,   -90,   -90,    13,    34,   -90,   -90,     2,   -90,   -90,
+     -90,    55,    83,     9,   -90,     6,    28,    16,    23,   -90,
+      30,    52,    32,    34,    50,    57,   -90,   -90,   -90,   -90,
+     -90,    34,   -90,    71,    -1,    -6,    73,    74,    -5,    10,
+     -90,    -7,   -90,   -90,   -90,   -90,   -90,   -90,   -90,   -90,
+      64,    86,    54,    66,   -90,   -90,    -7,    -7,   -90,    72,
+      -7,    -7,    75,   -90,    -7,    -7,    -7,    -7,    -7,    -7,
+      -7,    -7,    -7,    -7,    -7,    76,    78,   -90,   -90,    79,
+      77,   -90,    56,   -90,   -90,    70,    70,    70,    70,    70,
+      70,    66,    66,   -90,   -90,    31,    31,   -90,    -7,   -90,
+     -90,   105,   -90,   -90,   -90,    31,   -90,   -90
 };
 
-  /* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
-     Performed when YYTABLE does not specify something else to do.  Zero
-     means the default is an error.  */
-static const yytype_uint8 yydefact[] =
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_int8 yydefact[] =
 {
        0,     9,    10,     0,     2,     4,     5,     0,     6,     1,
-       3,    64,    11,     0,     7,     0,    65,     0,     0,     0,
-      10,     0,     0,    13,    16,     8,    17,     0,     0,     0,
-      21,    12,    15,    18,    23,    20,     0,     0,     0,     0,
-       0,     0,    57,     0,    19,    30,    25,    22,    24,    26,
-      27,    28,     0,    55,    44,    50,    53,    56,    45,     0,
-       0,    34,     0,     0,    29,     0,     0,     0,     0,     0,
-       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
-      35,    54,     0,    55,    39,    40,    38,    41,    43,    42,
-      48,    49,    51,    52,     0,    61,     0,     0,    37,     0,
-      63,     0,    60,    31,    33,    47,    59,     0,     0,    62,
-      32
+       3,     0,     0,     0,     7,    10,     0,     0,    12,    15,
+       0,    16,     0,     0,     0,     0,    20,    11,    14,     8,
+      17,    22,    19,     0,     0,     0,     0,     0,     0,    45,
+      56,     0,    18,    34,    26,    21,    23,    24,    25,    27,
+       0,    54,    44,    49,    52,    55,     0,     0,    35,     0,
+      59,     0,     0,    33,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    36,    61,     0,
+      58,    54,     0,    53,    37,    39,    40,    38,    41,    43,
+      42,    47,    48,    50,    51,     0,     0,    57,     0,    46,
+      30,    23,    29,    32,    60,     0,    28,    31
 };
 
-  /* YYPGOTO[NTERM-NUM].  */
+/* YYPGOTO[NTERM-NUM].  */
 static const yytype_int8 yypgoto[] =
 {
-     -92,   -92,   -92,   107,    81,    34,   -92,   -92,   -92,   -92,
-      84,    87,   -92,   -92,   -91,   -92,   -92,   -92,   -92,   -41,
-     -92,   -24,   -92,   -11,    20,    21,   -92,   -92,   -92,   -92,
-       2,   -92
+     -90,   -90,   -90,   106,    80,   -11,   -90,   -90,   -90,    90,
+      92,   -90,   -90,    20,   -89,   -66,   -90,   -90,   -38,   -17,
+       1,    25,    26,   -90,   -90,   -90
 };
 
-  /* YYDEFGOTO[NTERM-NUM].  */
+/* YYDEFGOTO[NTERM-NUM].  */
 static const yytype_int8 yydefgoto[] =
 {
-      -1,     3,     4,     5,     6,     7,     8,    15,    22,    23,
-      24,    46,    34,    37,    47,    48,    49,    50,    51,    52,
-      65,    53,    76,    54,    55,    56,    57,    77,   101,   102,
-      58,    17
+       0,     3,     4,     5,     6,     7,     8,    17,    18,    19,
+      44,    31,    34,    45,    46,    47,    48,    49,    50,    51,
+      52,    53,    54,    55,    79,    80
 };
 
-  /* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
-     positive, shift that token.  If negative, reduce the rule whose
-     number is the opposite.  If YYTABLE_NINF, syntax error.  */
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
 static const yytype_int8 yytable[] =
 {
-      62,    39,    63,    40,    41,   103,   104,     9,    39,    12,
-      40,    41,    11,    11,    42,    11,    42,   110,    78,    79,
-      11,    42,   -58,    26,   -46,    13,    43,    16,    43,    14,
-      30,    44,    45,    43,    61,     1,     2,    30,    38,    45,
-      18,    98,    83,    83,    83,    83,    83,    83,    83,    83,
-      83,    83,    21,    19,   100,    84,    85,    86,    87,    88,
-      89,    25,    21,    11,    42,   -14,   109,    27,    36,    29,
-      83,    72,    73,    30,     1,    20,    43,    28,   105,    74,
-      75,    72,    73,    99,    66,    67,    68,    69,    70,    71,
-      72,    73,    90,    91,    33,    92,    93,    59,    60,    64,
-     -36,    81,    80,    82,    94,    95,   107,    96,    97,   106,
-     108,    10,    32,     0,    31,    35
+      59,    16,    36,    62,    37,    38,   101,   102,    39,    40,
+      39,    40,    16,     9,    39,    40,   106,    11,    75,    76,
+      33,    41,    78,    41,    13,    20,    84,    41,    14,    58,
+     103,    26,    42,    43,    36,   -13,    37,    38,    60,   107,
+      61,     1,     2,    21,    81,    22,    39,    40,    81,    81,
+      81,    81,    81,    81,    81,    81,    81,    81,    23,    41,
+     104,    24,    82,    26,    26,    43,    85,    86,    87,    88,
+      89,    90,    65,    66,    67,    68,    69,    70,    71,    72,
+      71,    72,    25,    12,    29,    13,    35,    99,    30,    14,
+       1,    15,    73,    74,    71,    72,    91,    92,    63,    93,
+      94,    56,    57,    64,    83,    95,    77,    96,    97,   105,
+      10,    32,    98,    28,    27,   100
 };
 
 static const yytype_int8 yycheck[] =
 {
-      41,     3,    43,     5,     6,    96,    97,     0,     3,     7,
-       5,     6,    15,    15,    16,    15,    16,   108,    59,    60,
-      15,    16,    28,    21,    30,    30,    28,    16,    28,    34,
-      32,    33,    34,    28,    34,     7,     8,    32,    36,    34,
-      28,    82,    66,    67,    68,    69,    70,    71,    72,    73,
-      74,    75,    18,    31,    95,    66,    67,    68,    69,    70,
-      71,    34,    28,    15,    16,    29,   107,    29,    34,    30,
-      94,    24,    25,    32,     7,     8,    28,    35,    31,    26,
-      27,    24,    25,    94,    18,    19,    20,    21,    22,    23,
-      24,    25,    72,    73,    31,    74,    75,    28,    28,    34,
-      17,    29,    34,    17,    30,    28,    35,    29,    29,    29,
-       4,     4,    28,    -1,    27,    34
+      38,    12,     3,    41,     5,     6,    95,    96,    15,    16,
+      15,    16,    23,     0,    15,    16,   105,    15,    56,    57,
+      31,    28,    60,    28,    30,    16,    64,    28,    34,    34,
+      96,    32,    33,    34,     3,    29,     5,     6,    28,   105,
+      30,     7,     8,    15,    61,    29,    15,    16,    65,    66,
+      67,    68,    69,    70,    71,    72,    73,    74,    35,    28,
+      98,    31,    61,    32,    32,    34,    65,    66,    67,    68,
+      69,    70,    18,    19,    20,    21,    22,    23,    24,    25,
+      24,    25,    30,    28,    34,    30,    15,    31,    31,    34,
+       7,     8,    26,    27,    24,    25,    71,    72,    34,    73,
+      74,    28,    28,    17,    29,    29,    34,    29,    29,     4,
+       4,    31,    35,    23,    22,    95
 };
 
-  /* YYSTOS[STATE-NUM] -- The (internal number of the) accessing
-     symbol of state STATE-NUM.  */
-static const yytype_uint8 yystos[] =
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
 {
-       0,     7,     8,    39,    40,    41,    42,    43,    44,     0,
-      41,    15,    68,    30,    34,    45,    16,    69,    28,    31,
-       8,    43,    46,    47,    48,    34,    68,    29,    35,    30,
-      32,    49,    48,    31,    50,    42,    43,    51,    68,     3,
-       5,     6,    16,    28,    33,    34,    49,    52,    53,    54,
-      55,    56,    57,    59,    61,    62,    63,    64,    68,    28,
-      28,    34,    57,    57,    34,    58,    18,    19,    20,    21,
-      22,    23,    24,    25,    26,    27,    60,    65,    57,    57,
-      34,    29,    17,    59,    61,    61,    61,    61,    61,    61,
-      62,    62,    63,    63,    30,    28,    29,    29,    57,    61,
-      57,    66,    67,    52,    52,    31,    29,    35,     4,    57,
-      52
+       0,     7,     8,    38,    39,    40,    41,    42,    43,     0,
+      40,    15,    28,    30,    34,     8,    42,    44,    45,    46,
+      16,    15,    29,    35,    31,    30,    32,    47,    46,    34,
+      31,    48,    41,    42,    49,    15,     3,     5,     6,    15,
+      16,    28,    33,    34,    47,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    28,    28,    34,    55,
+      28,    30,    55,    34,    17,    18,    19,    20,    21,    22,
+      23,    24,    25,    26,    27,    55,    55,    34,    55,    61,
+      62,    56,    57,    29,    55,    57,    57,    57,    57,    57,
+      57,    58,    58,    59,    59,    29,    29,    29,    35,    31,
+      50,    51,    51,    52,    55,     4,    51,    52
 };
 
-  /* YYR1[YYN] -- Symbol number of symbol that rule YYN derives.  */
-static const yytype_uint8 yyr1[] =
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
 {
-       0,    38,    39,    40,    40,    41,    41,    42,    42,    43,
-      43,    45,    44,    46,    46,    47,    47,    48,    48,    49,
-      50,    50,    51,    51,    52,    52,    52,    52,    52,    53,
-      53,    54,    54,    55,    56,    56,    58,    57,    57,    57,
-      57,    57,    57,    57,    57,    59,    60,    59,    61,    61,
-      61,    62,    62,    62,    63,    63,    63,    63,    65,    64,
-      66,    66,    67,    67,    68,    69
+       0,    37,    38,    39,    39,    40,    40,    41,    41,    42,
+      42,    43,    44,    44,    45,    45,    46,    46,    47,    48,
+      48,    49,    49,    50,    50,    51,    51,    51,    51,    51,
+      52,    52,    52,    53,    53,    54,    54,    55,    55,    55,
+      55,    55,    55,    55,    55,    56,    56,    57,    57,    57,
+      58,    58,    58,    59,    59,    59,    59,    60,    61,    61,
+      62,    62
 };
 
-  /* YYR2[YYN] -- Number of symbols on the right hand side of rule YYN.  */
-static const yytype_uint8 yyr2[] =
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
 {
        0,     2,     1,     2,     1,     1,     1,     3,     6,     1,
-       1,     0,     7,     1,     1,     3,     1,     2,     4,     4,
-       2,     0,     2,     0,     1,     1,     1,     1,     1,     2,
-       1,     5,     7,     5,     2,     3,     0,     4,     3,     3,
-       3,     3,     3,     3,     1,     1,     0,     5,     3,     3,
-       1,     3,     3,     1,     3,     1,     1,     1,     0,     5,
-       1,     0,     3,     1,     1,     1
+       1,     6,     1,     1,     3,     1,     2,     4,     4,     2,
+       0,     2,     0,     1,     1,     1,     1,     1,     7,     5,
+       5,     7,     5,     2,     1,     2,     3,     3,     3,     3,
+       3,     3,     3,     3,     1,     1,     4,     3,     3,     1,
+       3,     3,     1,     3,     1,     1,     1,     4,     1,     0,
+       3,     1
 };
 
 
+enum { YYENOMEM = -2 };
+
 #define yyerrok         (yyerrstatus = 0)
 #define yyclearin       (yychar = YYEMPTY)
-#define YYEMPTY         (-2)
-#define YYEOF           0
 
 #define YYACCEPT        goto yyacceptlab
 #define YYABORT         goto yyabortlab
 #define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
 
 
 #define YYRECOVERING()  (!!yyerrstatus)
 
-#define YYBACKUP(Token, Value)                                  \
-do                                                              \
-  if (yychar == YYEMPTY)                                        \
-    {                                                           \
-      yychar = (Token);                                         \
-      yylval = (Value);                                         \
-      YYPOPSTACK (yylen);                                       \
-      yystate = *yyssp;                                         \
-      goto yybackup;                                            \
-    }                                                           \
-  else                                                          \
-    {                                                           \
-      yyerror (YY_("syntax error: cannot back up")); \
-      YYERROR;                                                  \
-    }                                                           \
-while (0)
-
-/* Error token number */
-#define YYTERROR        1
-#define YYERRCODE       256
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+/* YYLLOC_DEFAULT -- Set CURRENT to span from RHS[1] to RHS[N].
+   If N is 0, then set CURRENT to the empty location which ends
+   the previous symbol: RHS[0] (always defined).  */
+
+#ifndef YYLLOC_DEFAULT
+# define YYLLOC_DEFAULT(Current, Rhs, N)                                \
+    do                                                                  \
+      if (N)                                                            \
+        {                                                               \
+          (Current).first_line   = YYRHSLOC (Rhs, 1).first_line;        \
+          (Current).first_column = YYRHSLOC (Rhs, 1).first_column;      \
+          (Current).last_line    = YYRHSLOC (Rhs, N).last_line;         \
+          (Current).last_column  = YYRHSLOC (Rhs, N).last_column;       \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          (Current).first_line   = (Current).last_line   =              \
+            YYRHSLOC (Rhs, 0).last_line;                                \
+          (Current).first_column = (Current).last_column =              \
+            YYRHSLOC (Rhs, 0).last_column;                              \
+        }                                                               \
+    while (0)
+#endif
 
+#define YYRHSLOC(Rhs, K) ((Rhs)[K])
 
 
 /* Enable debugging if requested.  */
@@ -738,55 +954,112 @@ do {                                            \
     YYFPRINTF Args;                             \
 } while (0)
 
-/* This macro is provided for backward compatibility. */
-#ifndef YY_LOCATION_PRINT
-# define YY_LOCATION_PRINT(File, Loc) ((void) 0)
-#endif
+
+/* YYLOCATION_PRINT -- Print the location on the stream.
+   This macro was not mandated originally: define only if we know
+   we won't break user code: when these are the locations we know.  */
+
+# ifndef YYLOCATION_PRINT
+
+#  if defined YY_LOCATION_PRINT
+
+   /* Temporary convenience wrapper in case some people defined the
+      undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YYLOCATION_PRINT(File, Loc)  YY_LOCATION_PRINT(File, *(Loc))
+
+#  elif defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+
+/* Print *YYLOCP on YYO.  Private, do not rely on its existence. */
+
+YY_ATTRIBUTE_UNUSED
+static int
+yy_location_print_ (FILE *yyo, YYLTYPE const * const yylocp)
+{
+  int res = 0;
+  int end_col = 0 != yylocp->last_column ? yylocp->last_column - 1 : 0;
+  if (0 <= yylocp->first_line)
+    {
+      res += YYFPRINTF (yyo, "%d", yylocp->first_line);
+      if (0 <= yylocp->first_column)
+        res += YYFPRINTF (yyo, ".%d", yylocp->first_column);
+    }
+  if (0 <= yylocp->last_line)
+    {
+      if (yylocp->first_line < yylocp->last_line)
+        {
+          res += YYFPRINTF (yyo, "-%d", yylocp->last_line);
+          if (0 <= end_col)
+            res += YYFPRINTF (yyo, ".%d", end_col);
+        }
+      else if (0 <= end_col && yylocp->first_column < end_col)
+        res += YYFPRINTF (yyo, "-%d", end_col);
+    }
+  return res;
+}
+
+#   define YYLOCATION_PRINT  yy_location_print_
+
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT(File, Loc)  YYLOCATION_PRINT(File, &(Loc))
+
+#  else
+
+#   define YYLOCATION_PRINT(File, Loc) ((void) 0)
+    /* Temporary convenience wrapper in case some people defined the
+       undocumented and private YY_LOCATION_PRINT macros.  */
+#   define YY_LOCATION_PRINT  YYLOCATION_PRINT
+
+#  endif
+# endif /* !defined YYLOCATION_PRINT */
 
 
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)                    \
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
 do {                                                                      \
   if (yydebug)                                                            \
     {                                                                     \
       YYFPRINTF (stderr, "%s ", Title);                                   \
       yy_symbol_print (stderr,                                            \
-                  Type, Value); \
+                  Kind, Value, Location); \
       YYFPRINTF (stderr, "\n");                                           \
     }                                                                     \
 } while (0)
 
 
-/*----------------------------------------.
-| Print this symbol's value on YYOUTPUT.  |
-`----------------------------------------*/
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
 
 static void
-yy_symbol_value_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
-  FILE *yyo = yyoutput;
-  YYUSE (yyo);
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (yylocationp);
   if (!yyvaluep)
     return;
-# ifdef YYPRINT
-  if (yytype < YYNTOKENS)
-    YYPRINT (yyoutput, yytoknum[yytype], *yyvaluep);
-# endif
-  YYUSE (yytype);
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-/*--------------------------------.
-| Print this symbol on YYOUTPUT.  |
-`--------------------------------*/
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
 
 static void
-yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, YYLTYPE const * const yylocationp)
 {
-  YYFPRINTF (yyoutput, "%s %s (",
-             yytype < YYNTOKENS ? "token" : "nterm", yytname[yytype]);
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
 
-  yy_symbol_value_print (yyoutput, yytype, yyvaluep);
-  YYFPRINTF (yyoutput, ")");
+  YYLOCATION_PRINT (yyo, yylocationp);
+  YYFPRINTF (yyo, ": ");
+  yy_symbol_value_print (yyo, yykind, yyvaluep, yylocationp);
+  YYFPRINTF (yyo, ")");
 }
 
 /*------------------------------------------------------------------.
@@ -795,7 +1068,7 @@ yy_symbol_print (FILE *yyoutput, int yytype, YYSTYPE const * const yyvaluep)
 `------------------------------------------------------------------*/
 
 static void
-yy_stack_print (yytype_int16 *yybottom, yytype_int16 *yytop)
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
 {
   YYFPRINTF (stderr, "Stack now");
   for (; yybottom <= yytop; yybottom++)
@@ -818,21 +1091,22 @@ do {                                                            \
 `------------------------------------------------*/
 
 static void
-yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule)
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp, YYLTYPE *yylsp,
+                 int yyrule)
 {
-  unsigned long int yylno = yyrline[yyrule];
+  int yylno = yyrline[yyrule];
   int yynrhs = yyr2[yyrule];
   int yyi;
-  YYFPRINTF (stderr, "Reducing stack by rule %d (line %lu):\n",
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
              yyrule - 1, yylno);
   /* The symbols being reduced.  */
   for (yyi = 0; yyi < yynrhs; yyi++)
     {
       YYFPRINTF (stderr, "   $%d = ", yyi + 1);
       yy_symbol_print (stderr,
-                       yystos[yyssp[yyi + 1 - yynrhs]],
-                       &(yyvsp[(yyi + 1) - (yynrhs)])
-                                              );
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)],
+                       &(yylsp[(yyi + 1) - (yynrhs)]));
       YYFPRINTF (stderr, "\n");
     }
 }
@@ -840,15 +1114,15 @@ yy_reduce_print (yytype_int16 *yyssp, YYSTYPE *yyvsp, int yyrule)
 # define YY_REDUCE_PRINT(Rule)          \
 do {                                    \
   if (yydebug)                          \
-    yy_reduce_print (yyssp, yyvsp, Rule); \
+    yy_reduce_print (yyssp, yyvsp, yylsp, Rule); \
 } while (0)
 
 /* Nonzero means print parse trace.  It is left uninitialized so that
    multiple parsers can coexist.  */
 int yydebug;
 #else /* !YYDEBUG */
-# define YYDPRINTF(Args)
-# define YY_SYMBOL_PRINT(Title, Type, Value, Location)
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
 # define YY_STACK_PRINT(Bottom, Top)
 # define YY_REDUCE_PRINT(Rule)
 #endif /* !YYDEBUG */
@@ -869,406 +1143,304 @@ int yydebug;
 #ifndef YYMAXDEPTH
 # define YYMAXDEPTH 10000
 #endif
+/* Parser data structure.  */
+struct yypstate
+  {
+    yy_state_fast_t yystate;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus;
 
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
 
-#if YYERROR_VERBOSE
-
-# ifndef yystrlen
-#  if defined __GLIBC__ && defined _STRING_H
-#   define yystrlen strlen
-#  else
-/* Return the length of YYSTR.  */
-static YYSIZE_T
-yystrlen (const char *yystr)
-{
-  YYSIZE_T yylen;
-  for (yylen = 0; yystr[yylen]; yylen++)
-    continue;
-  return yylen;
-}
-#  endif
-# endif
-
-# ifndef yystpcpy
-#  if defined __GLIBC__ && defined _STRING_H && defined _GNU_SOURCE
-#   define yystpcpy stpcpy
-#  else
-/* Copy YYSRC to YYDEST, returning the address of the terminating '\0' in
-   YYDEST.  */
-static char *
-yystpcpy (char *yydest, const char *yysrc)
-{
-  char *yyd = yydest;
-  const char *yys = yysrc;
-
-  while ((*yyd++ = *yys++) != '\0')
-    continue;
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize;
 
-  return yyd - 1;
-}
-#  endif
-# endif
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss;
+    yy_state_t *yyssp;
 
-# ifndef yytnamerr
-/* Copy to YYRES the contents of YYSTR after stripping away unnecessary
-   quotes and backslashes, so that it's suitable for yyerror.  The
-   heuristic is that double-quoting is unnecessary unless the string
-   contains an apostrophe, a comma, or backslash (other than
-   backslash-backslash).  YYSTR is taken from yytname.  If YYRES is
-   null, do not copy; instead, return the length of what the result
-   would have been.  */
-static YYSIZE_T
-yytnamerr (char *yyres, const char *yystr)
-{
-  if (*yystr == '"')
-    {
-      YYSIZE_T yyn = 0;
-      char const *yyp = yystr;
-
-      for (;;)
-        switch (*++yyp)
-          {
-          case '\'':
-          case ',':
-            goto do_not_strip_quotes;
-
-          case '\\':
-            if (*++yyp != '\\')
-              goto do_not_strip_quotes;
-            /* Fall through.  */
-          default:
-            if (yyres)
-              yyres[yyn] = *yyp;
-            yyn++;
-            break;
-
-          case '"':
-            if (yyres)
-              yyres[yyn] = '\0';
-            return yyn;
-          }
-    do_not_strip_quotes: ;
-    }
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs;
+    YYSTYPE *yyvsp;
 
-  if (! yyres)
-    return yystrlen (yystr);
+    /* The location stack: array, bottom, top.  */
+    YYLTYPE yylsa[YYINITDEPTH];
+    YYLTYPE *yyls;
+    YYLTYPE *yylsp;
+    /* Whether this instance has not started parsing yet.
+     * If 2, it corresponds to a finished parsing.  */
+    int yynew;
+  };
 
-  return yystpcpy (yyres, yystr) - yyres;
-}
-# endif
+/* Whether the only allowed instance of yypstate is allocated.  */
+static char yypstate_allocated = 0;
 
-/* Copy into *YYMSG, which is of size *YYMSG_ALLOC, an error message
-   about the unexpected token YYTOKEN for the state stack whose top is
-   YYSSP.
 
-   Return 0 if *YYMSG was successfully written.  Return 1 if *YYMSG is
-   not large enough to hold the message.  In that case, also set
-   *YYMSG_ALLOC to the required number of bytes.  Return 2 if the
-   required number of bytes is too large to store.  */
-static int
-yysyntax_error (YYSIZE_T *yymsg_alloc, char **yymsg,
-                yytype_int16 *yyssp, int yytoken)
-{
-  YYSIZE_T yysize0 = yytnamerr (YY_NULLPTR, yytname[yytoken]);
-  YYSIZE_T yysize = yysize0;
-  enum { YYERROR_VERBOSE_ARGS_MAXIMUM = 5 };
-  /* Internationalized format string. */
-  const char *yyformat = YY_NULLPTR;
-  /* Arguments of yyformat. */
-  char const *yyarg[YYERROR_VERBOSE_ARGS_MAXIMUM];
-  /* Number of reported tokens (one for the "unexpected", one per
-     "expected"). */
-  int yycount = 0;
-
-  /* There are many possibilities here to consider:
-     - If this state is a consistent state with a default action, then
-       the only way this function was invoked is if the default action
-       is an error action.  In that case, don't check for expected
-       tokens because there are none.
-     - The only way there can be no lookahead present (in yychar) is if
-       this state is a consistent state with a default action.  Thus,
-       detecting the absence of a lookahead is sufficient to determine
-       that there is no unexpected or expected token to report.  In that
-       case, just report a simple "syntax error".
-     - Don't assume there isn't a lookahead just because this state is a
-       consistent state with a default action.  There might have been a
-       previous inconsistent state, consistent state with a non-default
-       action, or user semantic action that manipulated yychar.
-     - Of course, the expected token list depends on states to have
-       correct lookahead information, and it depends on the parser not
-       to perform extra reductions after fetching a lookahead from the
-       scanner and before detecting a syntax error.  Thus, state merging
-       (from LALR or IELR) and default reductions corrupt the expected
-       token list.  However, the list is correct for canonical LR with
-       one exception: it will still contain any token that will not be
-       accepted due to an error action in a later state.
-  */
-  if (yytoken != YYEMPTY)
-    {
-      int yyn = yypact[*yyssp];
-      yyarg[yycount++] = yytname[yytoken];
-      if (!yypact_value_is_default (yyn))
-        {
-          /* Start YYX at -YYN if negative to avoid negative indexes in
-             YYCHECK.  In other words, skip the first -YYN actions for
-             this state because they are default actions.  */
-          int yyxbegin = yyn < 0 ? -yyn : 0;
-          /* Stay within bounds of both yycheck and yytname.  */
-          int yychecklim = YYLAST - yyn + 1;
-          int yyxend = yychecklim < YYNTOKENS ? yychecklim : YYNTOKENS;
-          int yyx;
-
-          for (yyx = yyxbegin; yyx < yyxend; ++yyx)
-            if (yycheck[yyx + yyn] == yyx && yyx != YYTERROR
-                && !yytable_value_is_error (yytable[yyx + yyn]))
-              {
-                if (yycount == YYERROR_VERBOSE_ARGS_MAXIMUM)
-                  {
-                    yycount = 1;
-                    yysize = yysize0;
-                    break;
-                  }
-                yyarg[yycount++] = yytname[yyx];
-                {
-                  YYSIZE_T yysize1 = yysize + yytnamerr (YY_NULLPTR, yytname[yyx]);
-                  if (! (yysize <= yysize1
-                         && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-                    return 2;
-                  yysize = yysize1;
-                }
-              }
-        }
-    }
 
-  switch (yycount)
-    {
-# define YYCASE_(N, S)                      \
-      case N:                               \
-        yyformat = S;                       \
-      break
-      YYCASE_(0, YY_("syntax error"));
-      YYCASE_(1, YY_("syntax error, unexpected %s"));
-      YYCASE_(2, YY_("syntax error, unexpected %s, expecting %s"));
-      YYCASE_(3, YY_("syntax error, unexpected %s, expecting %s or %s"));
-      YYCASE_(4, YY_("syntax error, unexpected %s, expecting %s or %s or %s"));
-      YYCASE_(5, YY_("syntax error, unexpected %s, expecting %s or %s or %s or %s"));
-# undef YYCASE_
-    }
 
-  {
-    YYSIZE_T yysize1 = yysize + yystrlen (yyformat);
-    if (! (yysize <= yysize1 && yysize1 <= YYSTACK_ALLOC_MAXIMUM))
-      return 2;
-    yysize = yysize1;
-  }
 
-  if (*yymsg_alloc < yysize)
-    {
-      *yymsg_alloc = 2 * yysize;
-      if (! (yysize <= *yymsg_alloc
-             && *yymsg_alloc <= YYSTACK_ALLOC_MAXIMUM))
-        *yymsg_alloc = YYSTACK_ALLOC_MAXIMUM;
-      return 1;
-    }
-
-  /* Avoid sprintf, as that infringes on the user's name space.
-     Don't have undefined behavior even if the translation
-     produced a string with the wrong number of "%s"s.  */
-  {
-    char *yyp = *yymsg;
-    int yyi = 0;
-    while ((*yyp = *yyformat) != '\0')
-      if (*yyp == '%' && yyformat[1] == 's' && yyi < yycount)
-        {
-          yyp += yytnamerr (yyp, yyarg[yyi++]);
-          yyformat += 2;
-        }
-      else
-        {
-          yyp++;
-          yyformat++;
-        }
-  }
-  return 0;
-}
-#endif /* YYERROR_VERBOSE */
 
 /*-----------------------------------------------.
 | Release the memory associated to this symbol.  |
 `-----------------------------------------------*/
 
 static void
-yydestruct (const char *yymsg, int yytype, YYSTYPE *yyvaluep)
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, YYLTYPE *yylocationp)
 {
-  YYUSE (yyvaluep);
+  YY_USE (yyvaluep);
+  YY_USE (yylocationp);
   if (!yymsg)
     yymsg = "Deleting";
-  YY_SYMBOL_PRINT (yymsg, yytype, yyvaluep, yylocationp);
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
 
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
-  YYUSE (yytype);
+  YY_USE (yykind);
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 }
 
 
-
-
-/* The lookahead symbol.  */
+/* Lookahead token kind.  */
 int yychar;
 
 /* The semantic value of the lookahead symbol.  */
 YYSTYPE yylval;
+/* Location data for the lookahead symbol.  */
+YYLTYPE yylloc
+# if defined YYLTYPE_IS_TRIVIAL && YYLTYPE_IS_TRIVIAL
+  = { 1, 1, 1, 1 }
+# endif
+;
 /* Number of syntax errors so far.  */
 int yynerrs;
 
 
-/*----------.
-| yyparse.  |
-`----------*/
 
-int
-yyparse (void)
+
+#define yystate yyps->yystate
+#define yyerrstatus yyps->yyerrstatus
+#define yyssa yyps->yyssa
+#define yyss yyps->yyss
+#define yyssp yyps->yyssp
+#define yyvsa yyps->yyvsa
+#define yyvs yyps->yyvs
+#define yyvsp yyps->yyvsp
+#define yylsa yyps->yylsa
+#define yyls yyps->yyls
+#define yylsp yyps->yylsp
+#define yystacksize yyps->yystacksize
+
+/* Initialize the parser data structure.  */
+static void
+yypstate_clear (yypstate *yyps)
 {
-    int yystate;
-    /* Number of tokens to shift before error messages enabled.  */
-    int yyerrstatus;
+  yynerrs = 0;
+  yystate = 0;
+  yyerrstatus = 0;
 
-    /* The stacks and their tools:
-       'yyss': related to states.
-       'yyvs': related to semantic values.
+  yyssp = yyss;
+  yyvsp = yyvs;
+  yylsp = yyls;
 
-       Refer to the stacks through separate pointers, to allow yyoverflow
-       to reallocate them elsewhere.  */
+  /* Initialize the state stack, in case yypcontext_expected_tokens is
+     called before the first call to yyparse. */
+  *yyssp = 0;
+  yyps->yynew = 1;
+}
 
-    /* The state stack.  */
-    yytype_int16 yyssa[YYINITDEPTH];
-    yytype_int16 *yyss;
-    yytype_int16 *yyssp;
+/* Initialize the parser data structure.  */
+yypstate *
+yypstate_new (void)
+{
+  yypstate *yyps;
+  if (yypstate_allocated)
+    return YY_NULLPTR;
+  yyps = YY_CAST (yypstate *, YYMALLOC (sizeof *yyps));
+  if (!yyps)
+    return YY_NULLPTR;
+  yypstate_allocated = 1;
+  yystacksize = YYINITDEPTH;
+  yyss = yyssa;
+  yyvs = yyvsa;
+  yyls = yylsa;
+  yypstate_clear (yyps);
+  return yyps;
+}
 
-    /* The semantic value stack.  */
-    YYSTYPE yyvsa[YYINITDEPTH];
-    YYSTYPE *yyvs;
-    YYSTYPE *yyvsp;
+void
+yypstate_delete (yypstate *yyps)
+{
+  if (yyps)
+    {
+#ifndef yyoverflow
+      /* If the stack was reallocated but the parse did not complete, then the
+         stack still needs to be freed.  */
+      if (yyss != yyssa)
+        YYSTACK_FREE (yyss);
+#endif
+      YYFREE (yyps);
+      yypstate_allocated = 0;
+    }
+}
 
-    YYSIZE_T yystacksize;
+
+
+/*---------------.
+| yypush_parse.  |
+`---------------*/
+
+int
+yypush_parse (yypstate *yyps)
+{
+  int yypushed_char = yychar;
+  YYSTYPE yypushed_val = yylval;
+  YYLTYPE yypushed_loc = yylloc;
 
   int yyn;
+  /* The return value of yyparse.  */
   int yyresult;
-  /* Lookahead token as an internal (translated) token number.  */
-  int yytoken = 0;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
   /* The variables used to return semantic value and location from the
      action routines.  */
   YYSTYPE yyval;
+  YYLTYPE yyloc;
+
+  /* The locations where the error started and ended.  */
+  YYLTYPE yyerror_range[3];
 
-#if YYERROR_VERBOSE
-  /* Buffer for error messages, and its allocated size.  */
-  char yymsgbuf[128];
-  char *yymsg = yymsgbuf;
-  YYSIZE_T yymsg_alloc = sizeof yymsgbuf;
-#endif
 
-#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N), yylsp -= (N))
 
   /* The number of symbols on the RHS of the reduced rule.
      Keep to zero when no symbol should be popped.  */
   int yylen = 0;
 
-  yyssp = yyss = yyssa;
-  yyvsp = yyvs = yyvsa;
-  yystacksize = YYINITDEPTH;
+  switch (yyps->yynew)
+    {
+    case 0:
+      yyn = yypact[yystate];
+      goto yyread_pushed_token;
+
+    case 2:
+      yypstate_clear (yyps);
+      break;
+
+    default:
+      break;
+    }
 
   YYDPRINTF ((stderr, "Starting parse\n"));
 
-  yystate = 0;
-  yyerrstatus = 0;
-  yynerrs = 0;
   yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  yylsp[0] = yypushed_loc;
   goto yysetstate;
 
+
 /*------------------------------------------------------------.
-| yynewstate -- Push a new state, which is found in yystate.  |
+| yynewstate -- push a new state, which is found in yystate.  |
 `------------------------------------------------------------*/
- yynewstate:
+yynewstate:
   /* In all cases, when you get here, the value and location stacks
      have just been pushed.  So pushing a state here evens the stacks.  */
   yyssp++;
 
- yysetstate:
-  *yyssp = yystate;
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
 
   if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
     {
       /* Get the current used size of the three stacks, in elements.  */
-      YYSIZE_T yysize = yyssp - yyss + 1;
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
 
-#ifdef yyoverflow
+# if defined yyoverflow
       {
         /* Give user a chance to reallocate the stack.  Use copies of
            these so that the &'s don't force the real ones into
            memory.  */
+        yy_state_t *yyss1 = yyss;
         YYSTYPE *yyvs1 = yyvs;
-        yytype_int16 *yyss1 = yyss;
+        YYLTYPE *yyls1 = yyls;
 
         /* Each stack pointer address is followed by the size of the
            data in use in that stack, in bytes.  This used to be a
            conditional around just the two extra args, but that might
            be undefined if yyoverflow is a macro.  */
         yyoverflow (YY_("memory exhausted"),
-                    &yyss1, yysize * sizeof (*yyssp),
-                    &yyvs1, yysize * sizeof (*yyvsp),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yyls1, yysize * YYSIZEOF (*yylsp),
                     &yystacksize);
-
         yyss = yyss1;
         yyvs = yyvs1;
+        yyls = yyls1;
       }
-#else /* no yyoverflow */
-# ifndef YYSTACK_RELOCATE
-      goto yyexhaustedlab;
-# else
+# else /* defined YYSTACK_RELOCATE */
       /* Extend the stack our own way.  */
       if (YYMAXDEPTH <= yystacksize)
-        goto yyexhaustedlab;
+        YYNOMEM;
       yystacksize *= 2;
       if (YYMAXDEPTH < yystacksize)
         yystacksize = YYMAXDEPTH;
 
       {
-        yytype_int16 *yyss1 = yyss;
+        yy_state_t *yyss1 = yyss;
         union yyalloc *yyptr =
-          (union yyalloc *) YYSTACK_ALLOC (YYSTACK_BYTES (yystacksize));
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
         if (! yyptr)
-          goto yyexhaustedlab;
+          YYNOMEM;
         YYSTACK_RELOCATE (yyss_alloc, yyss);
         YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+        YYSTACK_RELOCATE (yyls_alloc, yyls);
 #  undef YYSTACK_RELOCATE
         if (yyss1 != yyssa)
           YYSTACK_FREE (yyss1);
       }
 # endif
-#endif /* no yyoverflow */
 
       yyssp = yyss + yysize - 1;
       yyvsp = yyvs + yysize - 1;
+      yylsp = yyls + yysize - 1;
 
-      YYDPRINTF ((stderr, "Stack size increased to %lu\n",
-                  (unsigned long int) yystacksize));
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
 
       if (yyss + yystacksize - 1 <= yyssp)
         YYABORT;
     }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
 
-  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
 
   if (yystate == YYFINAL)
     YYACCEPT;
 
   goto yybackup;
 
+
 /*-----------.
 | yybackup.  |
 `-----------*/
 yybackup:
-
   /* Do appropriate processing given the current state.  Read a
      lookahead token if we need one and don't already have one.  */
 
@@ -1279,18 +1451,43 @@ yybackup:
 
   /* Not known => get a lookahead token if don't already have one.  */
 
-  /* YYCHAR is either YYEMPTY or YYEOF or a valid lookahead symbol.  */
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
   if (yychar == YYEMPTY)
     {
-      YYDPRINTF ((stderr, "Reading a token: "));
-      yychar = yylex ();
+      if (!yyps->yynew)
+        {
+          YYDPRINTF ((stderr, "Return for a new token:\n"));
+          yyresult = YYPUSH_MORE;
+          goto yypushreturn;
+        }
+      yyps->yynew = 0;
+      /* Restoring the pushed token is only necessary for the first
+         yypush_parse invocation since subsequent invocations don't overwrite
+         it before jumping to yyread_pushed_token.  */
+      yychar = yypushed_char;
+      yylval = yypushed_val;
+      yylloc = yypushed_loc;
+yyread_pushed_token:
+      YYDPRINTF ((stderr, "Reading a token\n"));
     }
 
   if (yychar <= YYEOF)
     {
-      yychar = yytoken = YYEOF;
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
       YYDPRINTF ((stderr, "Now at end of input.\n"));
     }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      yyerror_range[1] = yylloc;
+      goto yyerrlab1;
+    }
   else
     {
       yytoken = YYTRANSLATE (yychar);
@@ -1318,15 +1515,14 @@ yybackup:
 
   /* Shift the lookahead token.  */
   YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
-
-  /* Discard the shifted token.  */
-  yychar = YYEMPTY;
-
   yystate = yyn;
   YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
+  *++yylsp = yylloc;
 
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
   goto yynewstate;
 
 
@@ -1341,7 +1537,7 @@ yydefault:
 
 
 /*-----------------------------.
-| yyreduce -- Do a reduction.  |
+| yyreduce -- do a reduction.  |
 `-----------------------------*/
 yyreduce:
   /* yyn is the number of a rule to reduce with.  */
@@ -1357,550 +1553,458 @@ yyreduce:
      GCC warning that YYVAL may be used uninitialized.  */
   yyval = yyvsp[1-yylen];
 
-
+  /* Default location. */
+  YYLLOC_DEFAULT (yyloc, (yylsp - yylen), yylen);
+  yyerror_range[1] = yyloc;
   YY_REDUCE_PRINT (yyn);
   switch (yyn)
     {
-        case 2:
-#line 37 "cminus.y" /* yacc.c:1646  */
-    { savedTree = (yyvsp[0]);}
-#line 1368 "y.tab.c" /* yacc.c:1646  */
+  case 2: /* program: decl_list  */
+#line 64 "cminus.y"
+                { savedTree = closeList((yyvsp[0].node));}
+#line 1566 "y.tab.c"
     break;
 
-  case 3:
-#line 40 "cminus.y" /* yacc.c:1646  */
-    { YYSTYPE t = (yyvsp[-1]);
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = (yyvsp[0]);
-                    (yyval) = (yyvsp[-1]); }
-                  else (yyval) = (yyvsp[0]);
+  case 3: /* decl_list: decl_list decl  */
+#line 67 "cminus.y"
+                { (yyval.node) = appendList((yyvsp[-1].node),(yyvsp[0].node));
+                  addTopDecl((yyvsp[0].node),(yylsp[0]));
                 }
-#line 1381 "y.tab.c" /* yacc.c:1646  */
+#line 1574 "y.tab.c"
     break;
 
-  case 4:
-#line 48 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1387 "y.tab.c" /* yacc.c:1646  */
+  case 4: /* decl_list: decl  */
+#line 71 "cminus.y"
+                { (yyval.node) = appendList(NONODE,(yyvsp[0].node));
+                  addTopDecl((yyvsp[0].node),(yylsp[0]));
+                }
+#line 1582 "y.tab.c"
     break;
 
-  case 5:
-#line 51 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1393 "y.tab.c" /* yacc.c:1646  */
+  case 5: /* decl: var_decl  */
+#line 76 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1588 "y.tab.c"
     break;
 
-  case 6:
-#line 53 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1399 "y.tab.c" /* yacc.c:1646  */
+  case 6: /* decl: fun_decl  */
+#line 78 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1594 "y.tab.c"
     break;
 
-  case 7:
-#line 56 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(VarDeclK);
-                  (yyval)->attr.name = savedName;
-                  (yyval)->attr.type = savedType;
-                  (yyval)->lineno = lineno;
+  case 7: /* var_decl: type_spec ID SEMI  */
+#line 81 "cminus.y"
+                { (yyval.node) = newStmtNode(VarDeclK);
+                  node((yyval.node))->attr.name = (yyvsp[-1].name);
+                  node((yyval.node))->decl = (yyvsp[-2].type);
+                  node((yyval.node))->offset = (yylsp[-1]);
                 }
-#line 1409 "y.tab.c" /* yacc.c:1646  */
+#line 1604 "y.tab.c"
     break;
 
-  case 8:
-#line 62 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(ArrVarDeclK);
-                  (yyval)->attr.name = savedName;
-                  (yyval)->attr.val = savedSize;
-                  (yyval)->attr.type = savedType;
-                  (yyval)->lineno = lineno;
+  case 8: /* var_decl: type_spec ID LBRACE NUM RBRACE SEMI  */
+#line 87 "cminus.y"
+                { (yyval.node) = newStmtNode(ArrVarDeclK);
+                  node((yyval.node))->attr.name = (yyvsp[-4].name);
+                  setArraySize((yyval.node),(yyvsp[-2].val));
+                  node((yyval.node))->decl = (yyvsp[-5].type);
+                  node((yyval.node))->offset = (yylsp[-4]);
                 }
-#line 1420 "y.tab.c" /* yacc.c:1646  */
-    break;
-
-  case 9:
-#line 70 "cminus.y" /* yacc.c:1646  */
-    { savedType = copyString(tokenString);}
-#line 1426 "y.tab.c" /* yacc.c:1646  */
+#line 1615 "y.tab.c"
     break;
 
-  case 10:
-#line 72 "cminus.y" /* yacc.c:1646  */
-    { savedType = copyString(tokenString);}
-#line 1432 "y.tab.c" /* yacc.c:1646  */
+  case 9: /* type_spec: INT  */
+#line 95 "cminus.y"
+                { (yyval.type) = Integer;}
+#line 1621 "y.tab.c"
     break;
 
-  case 11:
-#line 75 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(FunK);
-                  (yyval)->attr.name = savedName;
-                  (yyval)->attr.type = savedType;
-                }
-#line 1441 "y.tab.c" /* yacc.c:1646  */
+  case 10: /* type_spec: VOID  */
+#line 97 "cminus.y"
+                { (yyval.type) = Void;}
+#line 1627 "y.tab.c"
     break;
 
-  case 12:
-#line 80 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[-4]);
-                  (yyval)->lineno = lineno;
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
+  case 11: /* fun_decl: type_spec ID LPAREN params RPAREN comp_stmt  */
+#line 100 "cminus.y"
+                { (yyval.node) = newStmtNode(FunK);
+                  node((yyval.node))->attr.name = (yyvsp[-4].name);
+                  node((yyval.node))->decl = (yyvsp[-5].type);
+                  node((yyval.node))->offset = (yylsp[-4]);
+                  node((yyval.node))->child[0] = (yyvsp[-2].node);
+                  node((yyval.node))->child[1] = (yyvsp[0].node);
                 }
-#line 1451 "y.tab.c" /* yacc.c:1646  */
+#line 1639 "y.tab.c"
     break;
 
-  case 13:
-#line 87 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1457 "y.tab.c" /* yacc.c:1646  */
+  case 12: /* params: param_list  */
+#line 109 "cminus.y"
+                { (yyval.node) = closeList((yyvsp[0].node)); }
+#line 1645 "y.tab.c"
     break;
 
-  case 14:
-#line 89 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(ParamK);
-                  (yyval)->attr.name = "(null)";
-                  (yyval)->attr.type = "void";
-                  (yyval)->lineno = lineno;
+  case 13: /* params: VOID  */
+#line 111 "cminus.y"
+                { (yyval.node) = newStmtNode(ParamK);
+                  node((yyval.node))->attr.name = nullName;
+                  node((yyval.node))->decl = Void;
+                  node((yyval.node))->offset = (yylsp[0]);
                 }
-#line 1467 "y.tab.c" /* yacc.c:1646  */
+#line 1655 "y.tab.c"
     break;
 
-  case 15:
-#line 96 "cminus.y" /* yacc.c:1646  */
-    { YYSTYPE t = (yyvsp[-2]);
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = (yyvsp[0]);
-                    (yyval) = (yyvsp[-2]); }
-                  else (yyval) = (yyvsp[0]);
-                }
-#line 1480 "y.tab.c" /* yacc.c:1646  */
+  case 14: /* param_list: param_list COMMA param  */
+#line 118 "cminus.y"
+                { (yyval.node) = appendList((yyvsp[-2].node),(yyvsp[0].node)); }
+#line 1661 "y.tab.c"
     break;
 
-  case 16:
-#line 105 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1486 "y.tab.c" /* yacc.c:1646  */
-    break;
-
-  case 17:
-#line 108 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(ParamK);
-                  (yyval)->attr.name = savedName;
-                  (yyval)->attr.type = savedType;
-                  (yyval)->lineno = lineno;
-                }
-#line 1496 "y.tab.c" /* yacc.c:1646  */
+  case 15: /* param_list: param  */
+#line 120 "cminus.y"
+                { (yyval.node) = appendList(NONODE,(yyvsp[0].node)); }
+#line 1667 "y.tab.c"
     break;
 
-  case 18:
-#line 114 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(ArrParamK);
-                  (yyval)->attr.name = savedName;
-                  (yyval)->attr.type = savedType;
-                  (yyval)->lineno = lineno;
+  case 16: /* param: type_spec ID  */
+#line 123 "cminus.y"
+                { (yyval.node) = newStmtNode(ParamK);
+                  node((yyval.node))->attr.name = (yyvsp[0].name);
+                  node((yyval.node))->decl = (yyvsp[-1].type);
+                  node((yyval.node))->offset = (yylsp[0]);
                 }
-#line 1506 "y.tab.c" /* yacc.c:1646  */
+#line 1677 "y.tab.c"
     break;
 
-  case 19:
-#line 121 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(CompK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[-1]);
+  case 17: /* param: type_spec ID LBRACE RBRACE  */
+#line 129 "cminus.y"
+                { (yyval.node) = newStmtNode(ArrParamK);
+                  node((yyval.node))->attr.name = (yyvsp[-2].name);
+                  node((yyval.node))->decl = (yyvsp[-3].type);
+                  node((yyval.node))->offset = (yylsp[-2]);
                 }
-#line 1515 "y.tab.c" /* yacc.c:1646  */
+#line 1687 "y.tab.c"
     break;
 
-  case 20:
-#line 127 "cminus.y" /* yacc.c:1646  */
-    { YYSTYPE t = (yyvsp[-1]);
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = (yyvsp[0]);
-                    (yyval) = (yyvsp[-1]); }
-                  else (yyval) = (yyvsp[0]);
+  case 18: /* comp_stmt: LCURLY local_decl stmt_list RCURLY  */
+#line 136 "cminus.y"
+                { (yyval.node) = newStmtNode(CompK);
+                  node((yyval.node))->offset = (yylsp[-3]);
+                  node((yyval.node))->child[0] = closeList((yyvsp[-2].node));
+                  node((yyval.node))->child[1] = closeList((yyvsp[-1].node));
                 }
-#line 1528 "y.tab.c" /* yacc.c:1646  */
+#line 1697 "y.tab.c"
     break;
 
-  case 21:
-#line 135 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = NULL; }
-#line 1534 "y.tab.c" /* yacc.c:1646  */
+  case 19: /* local_decl: local_decl var_decl  */
+#line 143 "cminus.y"
+                { (yyval.node) = appendList((yyvsp[-1].node),(yyvsp[0].node)); }
+#line 1703 "y.tab.c"
     break;
 
-  case 22:
-#line 138 "cminus.y" /* yacc.c:1646  */
-    { YYSTYPE t = (yyvsp[-1]);
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = (yyvsp[0]);
-                    (yyval) = (yyvsp[-1]); }
-                  else (yyval) = (yyvsp[0]);
-                }
-#line 1547 "y.tab.c" /* yacc.c:1646  */
-    break;
-
-  case 23:
-#line 146 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = NULL; }
-#line 1553 "y.tab.c" /* yacc.c:1646  */
+  case 20: /* local_decl: %empty  */
+#line 144 "cminus.y"
+              { (yyval.node) = NONODE; }
+#line 1709 "y.tab.c"
     break;
 
-  case 24:
-#line 149 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1559 "y.tab.c" /* yacc.c:1646  */
+  case 21: /* stmt_list: stmt_list stmt  */
+#line 147 "cminus.y"
+                { (yyval.node) = appendList((yyvsp[-1].node),(yyvsp[0].node)); }
+#line 1715 "y.tab.c"
     break;
 
-  case 25:
-#line 151 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1565 "y.tab.c" /* yacc.c:1646  */
+  case 22: /* stmt_list: %empty  */
+#line 148 "cminus.y"
+              { (yyval.node) = NONODE; }
+#line 1721 "y.tab.c"
     break;
 
-  case 26:
-#line 153 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1571 "y.tab.c" /* yacc.c:1646  */
+  case 23: /* stmt: matched_stmt  */
+#line 155 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1727 "y.tab.c"
     break;
 
-  case 27:
-#line 155 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1577 "y.tab.c" /* yacc.c:1646  */
+  case 24: /* stmt: unmatched_stmt  */
+#line 157 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1733 "y.tab.c"
     break;
 
-  case 28:
-#line 157 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1583 "y.tab.c" /* yacc.c:1646  */
+  case 25: /* matched_stmt: exp_stmt  */
+#line 160 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1739 "y.tab.c"
     break;
 
-  case 29:
-#line 160 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[-1]); }
-#line 1589 "y.tab.c" /* yacc.c:1646  */
+  case 26: /* matched_stmt: comp_stmt  */
+#line 162 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1745 "y.tab.c"
     break;
 
-  case 30:
-#line 162 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = NULL; }
-#line 1595 "y.tab.c" /* yacc.c:1646  */
+  case 27: /* matched_stmt: ret_stmt  */
+#line 164 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1751 "y.tab.c"
     break;
 
-  case 31:
-#line 165 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(IfK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->child[2] = NULL;
+  case 28: /* matched_stmt: IF LPAREN exp RPAREN matched_stmt ELSE matched_stmt  */
+#line 166 "cminus.y"
+                { (yyval.node) = newStmtNode(IfK);
+                  node((yyval.node))->offset = (yylsp[-6]);
+                  node((yyval.node))->child[0] = (yyvsp[-4].node);
+                  node((yyval.node))->child[1] = (yyvsp[-2].node);
+                  node((yyval.node))->child[2] = (yyvsp[0].node);
                 }
-#line 1605 "y.tab.c" /* yacc.c:1646  */
+#line 1762 "y.tab.c"
     break;
 
-  case 32:
-#line 171 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(IfK);
-                  (yyval)->child[0] = (yyvsp[-4]);
-                  (yyval)->child[1] = (yyvsp[-2]);
-                  (yyval)->child[2] = (yyvsp[0]);
+  case 29: /* matched_stmt: WHILE LPAREN exp RPAREN matched_stmt  */
+#line 173 "cminus.y"
+                { (yyval.node) = newStmtNode(WhileK);
+                  node((yyval.node))->offset = (yylsp[-4]);
+                  node((yyval.node))->child[0] = (yyvsp[-2].node);
+                  node((yyval.node))->child[1] = (yyvsp[0].node);
                 }
-#line 1615 "y.tab.c" /* yacc.c:1646  */
+#line 1772 "y.tab.c"
     break;
 
-  case 33:
-#line 178 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(WhileK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
+  case 30: /* unmatched_stmt: IF LPAREN exp RPAREN stmt  */
+#line 180 "cminus.y"
+                { (yyval.node) = newStmtNode(IfK);
+                  node((yyval.node))->offset = (yylsp[-4]);
+                  node((yyval.node))->child[0] = (yyvsp[-2].node);
+                  node((yyval.node))->child[1] = (yyvsp[0].node);
+                  node((yyval.node))->child[2] = NONODE;
                 }
-#line 1624 "y.tab.c" /* yacc.c:1646  */
+#line 1783 "y.tab.c"
     break;
 
-  case 34:
-#line 184 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(RetK);
-                  (yyval)->child[0] = NULL;
+  case 31: /* unmatched_stmt: IF LPAREN exp RPAREN matched_stmt ELSE unmatched_stmt  */
+#line 187 "cminus.y"
+                { (yyval.node) = newStmtNode(IfK);
+                  node((yyval.node))->offset = (yylsp[-6]);
+                  node((yyval.node))->child[0] = (yyvsp[-4].node);
+                  node((yyval.node))->child[1] = (yyvsp[-2].node);
+                  node((yyval.node))->child[2] = (yyvsp[0].node);
                 }
-#line 1632 "y.tab.c" /* yacc.c:1646  */
+#line 1794 "y.tab.c"
     break;
 
-  case 35:
-#line 188 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(RetK);
-                  (yyval)->child[0] = (yyvsp[-1]);
+  case 32: /* unmatched_stmt: WHILE LPAREN exp RPAREN unmatched_stmt  */
+#line 194 "cminus.y"
+                { (yyval.node) = newStmtNode(WhileK);
+                  node((yyval.node))->offset = (yylsp[-4]);
+                  node((yyval.node))->child[0] = (yyvsp[-2].node);
+                  node((yyval.node))->child[1] = (yyvsp[0].node);
                 }
-#line 1640 "y.tab.c" /* yacc.c:1646  */
+#line 1804 "y.tab.c"
     break;
 
-  case 36:
-#line 193 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newStmtNode(AssignK);
-                  (yyval)->attr.name = savedName; 
-                }
-#line 1648 "y.tab.c" /* yacc.c:1646  */
+  case 33: /* exp_stmt: exp SEMI  */
+#line 201 "cminus.y"
+                { (yyval.node) = (yyvsp[-1].node); }
+#line 1810 "y.tab.c"
     break;
 
-  case 37:
-#line 197 "cminus.y" /* yacc.c:1646  */
-    { 
-                  (yyval) = (yyvsp[-2]);
-                  (yyval)->child[0] = (yyvsp[-3]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->lineno = (yyvsp[-3])->lineno;
-                }
-#line 1659 "y.tab.c" /* yacc.c:1646  */
+  case 34: /* exp_stmt: SEMI  */
+#line 203 "cminus.y"
+                { (yyval.node) = NONODE; }
+#line 1816 "y.tab.c"
     break;
 
-  case 38:
-#line 204 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = LT;
-                  (yyval)->lineno = (yyvsp[-2])->lineno;
+  case 35: /* ret_stmt: RETURN SEMI  */
+#line 206 "cminus.y"
+                { (yyval.node) = newStmtNode(RetK);
+                  node((yyval.node))->offset = (yylsp[-1]);
+                  node((yyval.node))->child[0] = NONODE;
                 }
-#line 1670 "y.tab.c" /* yacc.c:1646  */
+#line 1825 "y.tab.c"
     break;
 
-  case 39:
-#line 211 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = EQ;
-                  (yyval)->lineno = (yyvsp[-2])->lineno;
+  case 36: /* ret_stmt: RETURN exp SEMI  */
+#line 211 "cminus.y"
+                { (yyval.node) = newStmtNode(RetK);
+                  node((yyval.node))->offset = (yylsp[-2]);
+                  node((yyval.node))->child[0] = (yyvsp[-1].node);
                 }
-#line 1681 "y.tab.c" /* yacc.c:1646  */
+#line 1834 "y.tab.c"
     break;
 
-  case 40:
-#line 218 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = NE;
-                  (yyval)->lineno = (yyvsp[-2])->lineno;
+  case 37: /* exp: var ASSIGN exp  */
+#line 217 "cminus.y"
+                { (yyval.node) = newStmtNode(AssignK);
+                  node((yyval.node))->attr.name = node((yyvsp[-2].node))->attr.name;
+                  node((yyval.node))->child[0] = (yyvsp[-2].node);
+                  node((yyval.node))->child[1] = (yyvsp[0].node);
+                  node((yyval.node))->offset = node((yyvsp[-2].node))->offset;
                 }
-#line 1692 "y.tab.c" /* yacc.c:1646  */
+#line 1845 "y.tab.c"
     break;
 
-  case 41:
-#line 225 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = LE;
-                  (yyval)->lineno = (yyvsp[-2])->lineno;
-                }
-#line 1703 "y.tab.c" /* yacc.c:1646  */
+  case 38: /* exp: simple_exp LT simple_exp  */
+#line 224 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),LT,(yyvsp[0].node)); }
+#line 1851 "y.tab.c"
     break;
 
-  case 42:
-#line 232 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = GT;
-                  (yyval)->lineno = (yyvsp[-2])->lineno;
-                }
-#line 1714 "y.tab.c" /* yacc.c:1646  */
+  case 39: /* exp: simple_exp EQ simple_exp  */
+#line 226 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),EQ,(yyvsp[0].node)); }
+#line 1857 "y.tab.c"
     break;
 
-  case 43:
-#line 239 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = GE;
-                  (yyval)->lineno = (yyvsp[-2])->lineno;
-                }
-#line 1725 "y.tab.c" /* yacc.c:1646  */
+  case 40: /* exp: simple_exp NE simple_exp  */
+#line 228 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),NE,(yyvsp[0].node)); }
+#line 1863 "y.tab.c"
     break;
 
-  case 44:
-#line 246 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1731 "y.tab.c" /* yacc.c:1646  */
+  case 41: /* exp: simple_exp LE simple_exp  */
+#line 230 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),LE,(yyvsp[0].node)); }
+#line 1869 "y.tab.c"
     break;
 
-  case 45:
-#line 249 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(IdK);
-                  (yyval)->attr.name = savedName;
-                  (yyval)->lineno = lineno;
-                }
-#line 1740 "y.tab.c" /* yacc.c:1646  */
+  case 42: /* exp: simple_exp GT simple_exp  */
+#line 232 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),GT,(yyvsp[0].node)); }
+#line 1875 "y.tab.c"
     break;
 
-  case 46:
-#line 254 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(ArrIdK);
-                  (yyval)->attr.name = savedName;
-                }
-#line 1748 "y.tab.c" /* yacc.c:1646  */
+  case 43: /* exp: simple_exp GE simple_exp  */
+#line 234 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),GE,(yyvsp[0].node)); }
+#line 1881 "y.tab.c"
     break;
 
-  case 47:
-#line 258 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[-3]);
-                  (yyval)->child[0] = (yyvsp[-1]);
-                  (yyval)->lineno = lineno;
-                }
-#line 1757 "y.tab.c" /* yacc.c:1646  */
+  case 44: /* exp: simple_exp  */
+#line 236 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1887 "y.tab.c"
     break;
 
-  case 48:
-#line 264 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = PLUS;
-                  (yyval)->lineno = (yyvsp[-2])->lineno;
+  case 45: /* var: ID  */
+#line 239 "cminus.y"
+                { (yyval.node) = newExpNode(IdK);
+                  node((yyval.node))->attr.name = (yyvsp[0].name);
+                  node((yyval.node))->offset = (yylsp[0]);
                 }
-#line 1768 "y.tab.c" /* yacc.c:1646  */
+#line 1896 "y.tab.c"
     break;
 
-  case 49:
-#line 271 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = MINUS;
-                  (yyval)->lineno = (yyvsp[-2])->lineno;
+  case 46: /* var: ID LBRACE simple_exp RBRACE  */
+#line 244 "cminus.y"
+                { (yyval.node) = newExpNode(ArrIdK);
+                  node((yyval.node))->attr.name = (yyvsp[-3].name);
+                  node((yyval.node))->offset = (yylsp[-3]);
+                  node((yyval.node))->child[0] = (yyvsp[-1].node);
                 }
-#line 1779 "y.tab.c" /* yacc.c:1646  */
+#line 1906 "y.tab.c"
     break;
 
-  case 50:
-#line 278 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1785 "y.tab.c" /* yacc.c:1646  */
+  case 47: /* simple_exp: simple_exp PLUS term  */
+#line 251 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),PLUS,(yyvsp[0].node)); }
+#line 1912 "y.tab.c"
     break;
 
-  case 51:
-#line 281 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = TIMES;
-                }
-#line 1795 "y.tab.c" /* yacc.c:1646  */
+  case 48: /* simple_exp: simple_exp MINUS term  */
+#line 253 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),MINUS,(yyvsp[0].node)); }
+#line 1918 "y.tab.c"
     break;
 
-  case 52:
-#line 287 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(OpK);
-                  (yyval)->child[0] = (yyvsp[-2]);
-                  (yyval)->child[1] = (yyvsp[0]);
-                  (yyval)->attr.op = OVER;
-                }
-#line 1805 "y.tab.c" /* yacc.c:1646  */
+  case 49: /* simple_exp: term  */
+#line 255 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1924 "y.tab.c"
     break;
 
-  case 53:
-#line 293 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1811 "y.tab.c" /* yacc.c:1646  */
+  case 50: /* term: term TIMES factor  */
+#line 258 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),TIMES,(yyvsp[0].node)); }
+#line 1930 "y.tab.c"
     break;
 
-  case 54:
-#line 296 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[-1]); }
-#line 1817 "y.tab.c" /* yacc.c:1646  */
+  case 51: /* term: term OVER factor  */
+#line 260 "cminus.y"
+                { (yyval.node) = newOp((yyvsp[-2].node),OVER,(yyvsp[0].node)); }
+#line 1936 "y.tab.c"
     break;
 
-  case 55:
-#line 298 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1823 "y.tab.c" /* yacc.c:1646  */
+  case 52: /* term: factor  */
+#line 262 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1942 "y.tab.c"
     break;
 
-  case 56:
-#line 300 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1829 "y.tab.c" /* yacc.c:1646  */
+  case 53: /* factor: LPAREN exp RPAREN  */
+#line 265 "cminus.y"
+                { (yyval.node) = (yyvsp[-1].node); }
+#line 1948 "y.tab.c"
     break;
 
-  case 57:
-#line 302 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(ConstK);
-                  (yyval)->attr.val = atoi(tokenString);
-                }
-#line 1837 "y.tab.c" /* yacc.c:1646  */
+  case 54: /* factor: var  */
+#line 267 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1954 "y.tab.c"
     break;
 
-  case 58:
-#line 307 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = newExpNode(CallK);
-                  (yyval)->attr.name = savedName;
-                }
-#line 1845 "y.tab.c" /* yacc.c:1646  */
+  case 55: /* factor: call  */
+#line 269 "cminus.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 1960 "y.tab.c"
     break;
 
-  case 59:
-#line 311 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[-3]);
-                  (yyval)->child[0] = (yyvsp[-1]);
+  case 56: /* factor: NUM  */
+#line 271 "cminus.y"
+                { (yyval.node) = newExpNode(ConstK);
+                  node((yyval.node))->attr.val = (yyvsp[0].val);
+                  node((yyval.node))->offset = (yylsp[0]);
                 }
-#line 1853 "y.tab.c" /* yacc.c:1646  */
+#line 1969 "y.tab.c"
     break;
 
-  case 60:
-#line 316 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]);}
-#line 1859 "y.tab.c" /* yacc.c:1646  */
+  case 57: /* call: ID LPAREN args RPAREN  */
+#line 277 "cminus.y"
+                { (yyval.node) = newExpNode(CallK);
+                  node((yyval.node))->attr.name = (yyvsp[-3].name);
+                  node((yyval.node))->offset = (yylsp[-3]);
+                  node((yyval.node))->child[0] = (yyvsp[-1].node);
+                }
+#line 1979 "y.tab.c"
     break;
 
-  case 61:
-#line 317 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = NULL; }
-#line 1865 "y.tab.c" /* yacc.c:1646  */
+  case 58: /* args: arg_list  */
+#line 284 "cminus.y"
+                { (yyval.node) = closeList((yyvsp[0].node));}
+#line 1985 "y.tab.c"
     break;
 
-  case 62:
-#line 320 "cminus.y" /* yacc.c:1646  */
-    { YYSTYPE t = (yyvsp[-2]);
-                  if (t != NULL)
-                  { while (t->sibling != NULL)
-                        t = t->sibling;
-                    t->sibling = (yyvsp[0]);
-                    (yyval) = (yyvsp[-2]); }
-                  else (yyval) = (yyvsp[0]);
-                }
-#line 1878 "y.tab.c" /* yacc.c:1646  */
+  case 59: /* args: %empty  */
+#line 285 "cminus.y"
+              { (yyval.node) = NONODE; }
+#line 1991 "y.tab.c"
     break;
 
-  case 63:
-#line 329 "cminus.y" /* yacc.c:1646  */
-    { (yyval) = (yyvsp[0]); }
-#line 1884 "y.tab.c" /* yacc.c:1646  */
+  case 60: /* arg_list: arg_list COMMA exp  */
+#line 288 "cminus.y"
+                { (yyval.node) = appendList((yyvsp[-2].node),(yyvsp[0].node)); }
+#line 1997 "y.tab.c"
     break;
 
-  case 64:
-#line 332 "cminus.y" /* yacc.c:1646  */
-    { savedName = copyString(tokenString);
-                  savedLineNo = lineno;
-                }
-#line 1892 "y.tab.c" /* yacc.c:1646  */
+  case 61: /* arg_list: exp  */
+#line 290 "cminus.y"
+                { (yyval.node) = appendList(NONODE,(yyvsp[0].node)); }
+#line 2003 "y.tab.c"
     break;
 
-  case 65:
-#line 338 "cminus.y" /* yacc.c:1646  */
-    {savedSize = atoi(tokenString);
-                  savedLineNo = lineno;
-                }
-#line 1900 "y.tab.c" /* yacc.c:1646  */
-    break;
 
+#line 2007 "y.tab.c"
 
-#line 1904 "y.tab.c" /* yacc.c:1646  */
       default: break;
     }
   /* User semantic actions sometimes alter yychar, and that requires
@@ -1914,25 +2018,24 @@ yyreduce:
      case of YYERROR or YYBACKUP, subsequent parser actions might lead
      to an incorrect destructor call or verbose syntax error message
      before the lookahead is translated.  */
-  YY_SYMBOL_PRINT ("-> $$ =", yyr1[yyn], &yyval, &yyloc);
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
 
   YYPOPSTACK (yylen);
   yylen = 0;
-  YY_STACK_PRINT (yyss, yyssp);
 
   *++yyvsp = yyval;
+  *++yylsp = yyloc;
 
   /* Now 'shift' the result of the reduction.  Determine what state
      that goes to, based on the state we popped back to and the rule
      number reduced by.  */
-
-  yyn = yyr1[yyn];
-
-  yystate = yypgoto[yyn - YYNTOKENS] + *yyssp;
-  if (0 <= yystate && yystate <= YYLAST && yycheck[yystate] == *yyssp)
-    yystate = yytable[yystate];
-  else
-    yystate = yydefgoto[yyn - YYNTOKENS];
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
 
   goto yynewstate;
 
@@ -1943,50 +2046,15 @@ yyreduce:
 yyerrlab:
   /* Make sure we have latest lookahead translation.  See comments at
      user semantic actions for why this is necessary.  */
-  yytoken = yychar == YYEMPTY ? YYEMPTY : YYTRANSLATE (yychar);
-
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
   /* If not already recovering from an error, report this error.  */
   if (!yyerrstatus)
     {
       ++yynerrs;
-#if ! YYERROR_VERBOSE
       yyerror (YY_("syntax error"));
-#else
-# define YYSYNTAX_ERROR yysyntax_error (&yymsg_alloc, &yymsg, \
-                                        yyssp, yytoken)
-      {
-        char const *yymsgp = YY_("syntax error");
-        int yysyntax_error_status;
-        yysyntax_error_status = YYSYNTAX_ERROR;
-        if (yysyntax_error_status == 0)
-          yymsgp = yymsg;
-        else if (yysyntax_error_status == 1)
-          {
-            if (yymsg != yymsgbuf)
-              YYSTACK_FREE (yymsg);
-            yymsg = (char *) YYSTACK_ALLOC (yymsg_alloc);
-            if (!yymsg)
-              {
-                yymsg = yymsgbuf;
-                yymsg_alloc = sizeof yymsgbuf;
-                yysyntax_error_status = 2;
-              }
-            else
-              {
-                yysyntax_error_status = YYSYNTAX_ERROR;
-                yymsgp = yymsg;
-              }
-          }
-        yyerror (yymsgp);
-        if (yysyntax_error_status == 2)
-          goto yyexhaustedlab;
-      }
-# undef YYSYNTAX_ERROR
-#endif
     }
 
-
-
+  yyerror_range[1] = yylloc;
   if (yyerrstatus == 3)
     {
       /* If just tried and failed to reuse lookahead token after an
@@ -2001,7 +2069,7 @@ yyerrlab:
       else
         {
           yydestruct ("Error: discarding",
-                      yytoken, &yylval);
+                      yytoken, &yylval, &yylloc);
           yychar = YYEMPTY;
         }
     }
@@ -2015,12 +2083,11 @@ yyerrlab:
 | yyerrorlab -- error raised explicitly by YYERROR.  |
 `---------------------------------------------------*/
 yyerrorlab:
-
-  /* Pacify compilers like GCC when the user code never invokes
-     YYERROR and the label yyerrorlab therefore never appears in user
-     code.  */
-  if (/*CONSTCOND*/ 0)
-     goto yyerrorlab;
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
 
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYERROR.  */
@@ -2037,13 +2104,14 @@ yyerrorlab:
 yyerrlab1:
   yyerrstatus = 3;      /* Each real token shifted decrements this.  */
 
+  /* Pop stack until we find a state that shifts the error token.  */
   for (;;)
     {
       yyn = yypact[yystate];
       if (!yypact_value_is_default (yyn))
         {
-          yyn += YYTERROR;
-          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYTERROR)
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
             {
               yyn = yytable[yyn];
               if (0 < yyn)
@@ -2055,9 +2123,9 @@ yyerrlab1:
       if (yyssp == yyss)
         YYABORT;
 
-
+      yyerror_range[1] = *yylsp;
       yydestruct ("Error: popping",
-                  yystos[yystate], yyvsp);
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, yylsp);
       YYPOPSTACK (1);
       yystate = *yyssp;
       YY_STACK_PRINT (yyss, yyssp);
@@ -2067,9 +2135,12 @@ yyerrlab1:
   *++yyvsp = yylval;
   YY_IGNORE_MAYBE_UNINITIALIZED_END
 
+  yyerror_range[2] = yylloc;
+  ++yylsp;
+  YYLLOC_DEFAULT (*yylsp, yyerror_range, 2);
 
   /* Shift the error token.  */
-  YY_SYMBOL_PRINT ("Shifting", yystos[yyn], yyvsp, yylsp);
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
 
   yystate = yyn;
   goto yynewstate;
@@ -2080,33 +2151,37 @@ yyerrlab1:
 `-------------------------------------*/
 yyacceptlab:
   yyresult = 0;
-  goto yyreturn;
+  goto yyreturnlab;
+
 
 /*-----------------------------------.
 | yyabortlab -- YYABORT comes here.  |
 `-----------------------------------*/
 yyabortlab:
   yyresult = 1;
-  goto yyreturn;
+  goto yyreturnlab;
 
-#if !defined yyoverflow || YYERROR_VERBOSE
-/*-------------------------------------------------.
-| yyexhaustedlab -- memory exhaustion comes here.  |
-`-------------------------------------------------*/
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
 yyexhaustedlab:
   yyerror (YY_("memory exhausted"));
   yyresult = 2;
-  /* Fall through.  */
-#endif
+  goto yyreturnlab;
+
 
-yyreturn:
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
   if (yychar != YYEMPTY)
     {
       /* Make sure we have latest lookahead translation.  See comments at
          user semantic actions for why this is necessary.  */
       yytoken = YYTRANSLATE (yychar);
       yydestruct ("Cleanup: discarding lookahead",
-                  yytoken, &yylval);
+                  yytoken, &yylval, &yylloc);
     }
   /* Do not reclaim the symbols of the rule whose action triggered
      this YYABORT or YYACCEPT.  */
@@ -2115,38 +2190,185 @@ yyreturn:
   while (yyssp != yyss)
     {
       yydestruct ("Cleanup: popping",
-                  yystos[*yyssp], yyvsp);
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, yylsp);
       YYPOPSTACK (1);
     }
-#ifndef yyoverflow
-  if (yyss != yyssa)
-    YYSTACK_FREE (yyss);
-#endif
-#if YYERROR_VERBOSE
-  if (yymsg != yymsgbuf)
-    YYSTACK_FREE (yymsg);
-#endif
+  yyps->yynew = 2;
+  goto yypushreturn;
+
+
+/*-------------------------.
+| yypushreturn -- return.  |
+`-------------------------*/
+yypushreturn:
+
   return yyresult;
 }
-#line 343 "cminus.y" /* yacc.c:1906  */
 
+#undef yystate
+#undef yyerrstatus
+#undef yyssa
+#undef yyss
+#undef yyssp
+#undef yyvsa
+#undef yyvs
+#undef yyvsp
+#undef yylsa
+#undef yyls
+#undef yylsp
+#undef yystacksize
+#line 293 "cminus.y"
+
+
+/* A list under construction is kept circular and is
+ * referred to by its last node, whose sibling is the
+ * first; appendList then adds a node in constant time
+ * instead of walking the siblings to the end, and
+ * returns the new last node. closeList breaks the
+ * circle once the list is complete and returns its
+ * first node, as the syntax tree expects
+ */
+static NodeId appendList(NodeId last, NodeId t)
+{ if (t == NONODE) return last;
+  if (last == NONODE) node(t)->sibling = t;
+  else
+  { node(t)->sibling = node(last)->sibling;
+    node(last)->sibling = t;
+  }
+  return t;
+}
+
+static NodeId closeList(NodeId last)
+{ NodeId first;
+  if (last == NONODE) return NONODE;
+  first = node(last)->sibling;
+  node(last)->sibling = NONODE;
+  return first;
+}
+
+/* newOp makes the node of the binary operation op,
+ * located at its left operand */
+static NodeId newOp(NodeId left, TokenType op, NodeId right)
+{ NodeId t = newExpNode(OpK);
+  node(t)->child[0] = left;
+  node(t)->child[1] = right;
+  node(t)->attr.op = op;
+  node(t)->offset = node(left)->offset;
+  return t;
+}
+
+/* numValue returns the value of the NUM lexeme of
+ * tok, as strtol gives it, reading nothing past the
+ * lexeme: a scanner on another thread (see
+ * pipeparse.h) may be writing the byte after it
+ */
+static int numValue(const TokenRec * tok)
+{ const char * p = srcText + tok->offset;
+  long v = 0;
+  int i;
+  for (i=0;i<tok->length;i++)
+  { int d = p[i] - '0';
+    if (v > (LONG_MAX - d) / 10) v = LONG_MAX;
+    else v = 10*v + d;
+  }
+  return (int) v;
+}
 
 int yyerror(char * message)
-{ fprintf(listing,"Syntax error at line %d: %s\n",lineno,message);
+{ fprintf(listing,"Syntax error at line %d: %s\n",lineOf(yylloc),message);
   fprintf(listing,"Current token: ");
-  printToken(yychar,tokenString);
+  if (pushedToken->length > 0)
+    printTokenSpan(yychar,srcText+pushedToken->offset,pushedToken->length);
+  else
+    printToken(yychar,"");
   Error = TRUE;
   return 0;
 }
 
-/* yylex calls getToken to make Yacc/Bison output
- * compatible with ealier versions of the TINY scanner
+/* a push parse in progress */
+struct parseState
+   { yypstate * yyps;
+     ParseStatus status;
+     int offset; /* location of the last token pushed */
+   };
+
+/* Function parseStart begins a push parse */
+ParseState parseStart(void)
+{ ParseState ps = (ParseState) malloc(sizeof(struct parseState));
+  if (ps == NULL)
+  { fprintf(listing,"Out of memory error starting parse\n");
+    Error = TRUE;
+    return NULL;
+  }
+  ps->yyps = yypstate_new(); /* NULL while another parse is active */
+  if (ps->yyps == NULL)
+  { fprintf(listing,"Could not start parse\n");
+    Error = TRUE;
+    free(ps);
+    return NULL;
+  }
+  ps->status = ParseMore;
+  ps->offset = 0;
+  savedTree = NONODE;
+  nullName = internName("(null)",6);
+  return ps;
+}
+
+/* Function parsePush hands the n tokens at toks to
+ * the parse ps, in order
  */
-static int yylex(void)
-{ return getToken(); }
+ParseStatus parsePush(ParseState ps, const TokenRec * toks, int n)
+{ int i;
+  for (i=0;(i<n) && (ps->status == ParseMore);i++)
+  { int result;
+    pushedToken = &toks[i];
+    ps->offset = toks[i].offset;
+    /* the parser is not pure: the token is
+     * passed in yychar, yylval and yylloc */
+    yychar = toks[i].kind;
+    if (yychar == ID) yylval.name = toks[i].name;
+    else if (yychar == NUM) yylval.val = numValue(&toks[i]);
+    else yylval.node = NONODE;
+    yylloc = toks[i].offset;
+    result = yypush_parse(ps->yyps);
+    if (result == 0) ps->status = ParseDone;
+    else if (result != YYPUSH_MORE) ps->status = ParseError;
+  }
+  pushedToken = NULL;
+  return ps->status;
+}
 
-TreeNode * parse(void)
-{ yyparse();
+/* Function parseFinish ends the parse ps, returning
+ * its syntax tree
+ */
+NodeId parseFinish(ParseState ps)
+{ if (ps->status == ParseMore)
+  { /* the input stopped short: end it here */
+    TokenRec eof;
+    eof.kind = YYEOF;
+    eof.offset = ps->offset;
+    eof.length = 0;
+    eof.name = NULL;
+    parsePush(ps,&eof,1);
+  }
+  yypstate_delete(ps->yyps);
+  free(ps);
   return savedTree;
 }
 
+/* Function yaccParse pulls the tokens of the source
+ * from getToken and pushes them one at a time
+ */
+NodeId yaccParse(void)
+{ ParseState ps = parseStart();
+  TokenRec tok;
+  if (ps == NULL) return NONODE;
+  do
+  { tok.kind = getToken();
+    tok.offset = tokenOffset;
+    tok.length = tokenLength;
+    tok.name = tokenName;
+  } while (parsePush(ps,&tok,1) == ParseMore);
+  return parseFinish(ps);
+}
+
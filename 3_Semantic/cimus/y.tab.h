@@ -1,8 +1,9 @@
-/* A Bison parser, made by GNU Bison 3.0.4.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
 /* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989-1990, 2000-2015 Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
    This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
@@ -15,7 +16,7 @@
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <http://www.gnu.org/licenses/>.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -30,6 +31,10 @@
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
 #ifndef YY_YY_Y_TAB_H_INCLUDED
 # define YY_YY_Y_TAB_H_INCLUDED
 /* Debug traces.  */
@@ -40,49 +45,57 @@
 extern int yydebug;
 #endif
 
-/* Token type.  */
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
   enum yytokentype
   {
-    IF = 258,
-    ELSE = 259,
-    WHILE = 260,
-    RETURN = 261,
-    INT = 262,
-    VOID = 263,
-    THEN = 264,
-    END = 265,
-    REPEAT = 266,
-    UNTIL = 267,
-    READ = 268,
-    WRITE = 269,
-    ID = 270,
-    NUM = 271,
-    ASSIGN = 272,
-    EQ = 273,
-    NE = 274,
-    LT = 275,
-    LE = 276,
-    GE = 277,
-    GT = 278,
-    PLUS = 279,
-    MINUS = 280,
-    TIMES = 281,
-    OVER = 282,
-    LPAREN = 283,
-    RPAREN = 284,
-    LBRACE = 285,
-    RBRACE = 286,
-    LCURLY = 287,
-    RCURLY = 288,
-    SEMI = 289,
-    COMMA = 290,
-    ERROR = 291,
-    LOWER_THAN_ELSE = 292
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IF = 258,                      /* IF  */
+    ELSE = 259,                    /* ELSE  */
+    WHILE = 260,                   /* WHILE  */
+    RETURN = 261,                  /* RETURN  */
+    INT = 262,                     /* INT  */
+    VOID = 263,                    /* VOID  */
+    THEN = 264,                    /* THEN  */
+    END = 265,                     /* END  */
+    REPEAT = 266,                  /* REPEAT  */
+    UNTIL = 267,                   /* UNTIL  */
+    READ = 268,                    /* READ  */
+    WRITE = 269,                   /* WRITE  */
+    ID = 270,                      /* ID  */
+    NUM = 271,                     /* NUM  */
+    ASSIGN = 272,                  /* ASSIGN  */
+    EQ = 273,                      /* EQ  */
+    NE = 274,                      /* NE  */
+    LT = 275,                      /* LT  */
+    LE = 276,                      /* LE  */
+    GE = 277,                      /* GE  */
+    GT = 278,                      /* GT  */
+    PLUS = 279,                    /* PLUS  */
+    MINUS = 280,                   /* MINUS  */
+    TIMES = 281,                   /* TIMES  */
+    OVER = 282,                    /* OVER  */
+    LPAREN = 283,                  /* LPAREN  */
+    RPAREN = 284,                  /* RPAREN  */
+    LBRACE = 285,                  /* LBRACE  */
+    RBRACE = 286,                  /* RBRACE  */
+    LCURLY = 287,                  /* LCURLY  */
+    RCURLY = 288,                  /* RCURLY  */
+    SEMI = 289,                    /* SEMI  */
+    COMMA = 290,                   /* COMMA  */
+    ERROR = 291                    /* ERROR  */
   };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
+/* Token kinds.  */
+#define YYEMPTY -2
+#define YYEOF 0
+#define YYerror 256
+#define YYUNDEF 257
 #define IF 258
 #define ELSE 259
 #define WHILE 260
@@ -117,18 +130,52 @@ extern int yydebug;
 #define SEMI 289
 #define COMMA 290
 #define ERROR 291
-#define LOWER_THAN_ELSE 292
 
 /* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef int YYSTYPE;
+union YYSTYPE
+{
+#line 43 "cminus.y"
+ unsigned int node; char * name; int val; int type; 
+
+#line 142 "y.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
 # define YYSTYPE_IS_DECLARED 1
 #endif
 
+/* Location type.  */
+#if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
+typedef struct YYLTYPE YYLTYPE;
+struct YYLTYPE
+{
+  int first_line;
+  int first_column;
+  int last_line;
+  int last_column;
+};
+# define YYLTYPE_IS_DECLARED 1
+# define YYLTYPE_IS_TRIVIAL 1
+#endif
+
 
 extern YYSTYPE yylval;
+extern YYLTYPE yylloc;
+
+#ifndef YYPUSH_MORE_DEFINED
+# define YYPUSH_MORE_DEFINED
+enum { YYPUSH_MORE = 4 };
+#endif
+
+typedef struct yypstate yypstate;
+
+
+int yypush_parse (yypstate *ps);
+
+yypstate *yypstate_new (void);
+void yypstate_delete (yypstate *ps);
 
-int yyparse (void);
 
 #endif /* !YY_YY_Y_TAB_H_INCLUDED  */